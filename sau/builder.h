@@ -0,0 +1,68 @@
+/* SAU library: Program builder API, for use without a script.
+ * Copyright (c) 2024 Joel K. Pettersson
+ * <joelkp@tuta.io>.
+ *
+ * This file and the software of which it is part is distributed under the
+ * terms of the GNU Lesser General Public License, either version 3 or (at
+ * your option) any later version, WITHOUT ANY WARRANTY, not even of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * View the files COPYING.LESSER and COPYING for details, or if missing, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include "script.h"
+
+/*
+ * Builds a program (sauProgram) from calls made in the order of the
+ * content, like that of a script, without scanning or parsing text.
+ * The same timing, voice and operator allocation is used as for a
+ * script, so that a series of calls gives the program the matching
+ * script would give.
+ *
+ * Operators are referred to by the handles returned on adding them.
+ * Each call to add or update a top-level operator begins a new event,
+ * after any wait time added since the last event. Setting parameters
+ * and adding modulators then applies to the latest node made for the
+ * operator, which must have been made after the last duration group
+ * ended. (Like for a script, an update to a nested operator may also
+ * begin an event of its own, like a label reference to it would.)
+ * Setting a line or adding modulators for a parameter includes it in
+ * the update, with any values not given left unchanged, as naming it
+ * does in a script; "a.r" names both amplitude lines, so setting the
+ * second also includes the first.
+ *
+ * Handles stay valid until released, keeping the IDs of operators in
+ * use. After an operator and all others in its tree are released and
+ * voice use ends, their IDs can be reused, as is done for a script.
+ */
+
+struct sauBuilder;
+typedef struct sauBuilder sauBuilder;
+
+sauBuilder *sau_create_Builder(const char *restrict name,
+		const sauScriptOptions *restrict sopt) sauMalloclike;
+void sau_destroy_Builder(sauBuilder *restrict o);
+sauProgram *sau_finish_Builder(sauBuilder *restrict o);
+
+void sauBuilder_wait(sauBuilder *restrict o, uint32_t wait_ms);
+bool sauBuilder_end_group(sauBuilder *restrict o);
+
+uint32_t sauBuilder_add_op(sauBuilder *restrict o, uint8_t type,
+		uint32_t parent, uint8_t use_type);
+bool sauBuilder_update_op(sauBuilder *restrict o, uint32_t op);
+bool sauBuilder_release_op(sauBuilder *restrict o, uint32_t op);
+bool sauBuilder_clear_mods(sauBuilder *restrict o, uint32_t op,
+		uint8_t use_type);
+
+bool sauBuilder_set_line(sauBuilder *restrict o, uint32_t op,
+		uint8_t par, const sauLine *restrict line);
+bool sauBuilder_set_time(sauBuilder *restrict o, uint32_t op,
+		uint32_t time_ms);
+bool sauBuilder_set_phase(sauBuilder *restrict o, uint32_t op,
+		uint32_t phase);
+bool sauBuilder_set_seed(sauBuilder *restrict o, uint32_t op,
+		uint32_t seed);
+bool sauBuilder_set_mode(sauBuilder *restrict o, uint32_t op,
+		union sauPOPMode mode);
@@ -44,6 +44,20 @@
 # define sauPrintflike(string_index, first_to_check)
 #endif
 
+/*
+ * For SIMD-friendly loops, build a variant per instruction set
+ * and pick the best supported at load time (x86-64 with glibc).
+ * Elsewhere, the plain build is used, still auto-vectorizable.
+ */
+#if ((defined(__GNUC__) && __GNUC__ >= 6) || \
+     (defined(__clang__) && __clang_major__ >= 14)) && \
+    defined(__x86_64__) && defined(__ELF__) && defined(__GLIBC__) && \
+    !defined(SAU_NO_SIMDCLONES)
+# define sauSIMDclones __attribute__((target_clones("avx2", "default")))
+#else
+# define sauSIMDclones
+#endif
+
 /*
  * Utility macros.
  */
@@ -114,9 +128,6 @@ void sau_error(const char *restrict label, const char *restrict fmt, ...)
 /* Debug-friendly memory handling? (Slower.) */
 //#define SAU_MEM_DEBUG 1
 
-/* Print hash collision info for symtab. */
-//#define SAU_SYMTAB_STATS 0
-
 /* Print test statistics for scanner. */
 #define SAU_SCANNER_STATS 0
 
@@ -15,11 +15,30 @@
  * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
  */
 
+#ifndef SAU_FILE_MMAP
+/*
+ * Map regular files into memory for reading, where supported?
+ */
+# if defined(__unix__) || (defined(__APPLE__) && defined(__MACH__))
+#  define SAU_FILE_MMAP 1
+# else
+#  define SAU_FILE_MMAP 0
+# endif
+#endif
+#if SAU_FILE_MMAP
+# define _POSIX_C_SOURCE 200809L
+#endif
 #include <sau/file.h>
 #include <math.h>
 #include <string.h>
 #include <stdlib.h>
 #include <stdio.h>
+#if SAU_FILE_MMAP
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <unistd.h>
+#endif
 
 #define GETD_ALLOW_TAIL_DOT 0
 
@@ -112,6 +131,20 @@ static size_t mode_strread(sauFile *restrict o);
 
 static void ref_fclose(sauFile *restrict o);
 
+#if SAU_FILE_MMAP
+/*
+ * Memory-mapped file, and the current position reading it.
+ */
+typedef struct MapRef {
+	uint8_t *mem;
+	size_t len, pos;
+} MapRef;
+
+static size_t mode_mapread(sauFile *restrict o);
+
+static void ref_unmap(sauFile *restrict o);
+#endif
+
 /**
  * Open stdio file for reading.
  * (If a file was already opened, it is closed on success.)
@@ -132,6 +165,44 @@ bool sauFile_fopenrb(sauFile *restrict o, const char *restrict path) {
 	return true;
 }
 
+/**
+ * Open file for reading, mapping it into memory if it is a regular
+ * file and this is supported, otherwise using stdio as for
+ * sauFile_fopenrb(). (If a file was already opened, it is
+ * closed on success.)
+ *
+ * A mapped file is copied into the buffer one area at a time, like
+ * a string, with no further system calls before it is unmapped.
+ * It is unmapped upon EOF, like a stdio file is closed, and
+ * \a path is also kept the same way.
+ *
+ * \return true on success
+ */
+bool sauFile_mapopenrb(sauFile *restrict o, const char *restrict path) {
+	if (!path)
+		return false;
+#if SAU_FILE_MMAP
+	int fd = open(path, O_RDONLY);
+	if (fd < 0)
+		return false;
+	struct stat st;
+	MapRef *ref = NULL;
+	void *mem = MAP_FAILED;
+	if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0 &&
+	    (uintmax_t) st.st_size <= SIZE_MAX &&
+	    (ref = malloc(sizeof(MapRef))) != NULL)
+		mem = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (mem != MAP_FAILED) {
+		*ref = (MapRef){mem, st.st_size, 0};
+		sauFile_init(o, mode_mapread, ref, path, ref_unmap);
+		return true;
+	}
+	free(ref);
+#endif
+	return sauFile_fopenrb(o, path);
+}
+
 /**
  * Open string as file for reading. The string must be NULL-terminated.
  * The path is optional and only used to name the file.
@@ -259,6 +330,46 @@ static size_t mode_strread(sauFile *restrict o) {
 	return len;
 }
 
+#if SAU_FILE_MMAP
+/*
+ * Copy up to a buffer area of data from a memory-mapped file.
+ * Unmaps file upon reaching its end.
+ *
+ * Upon short read, inserts sauFile_STATUS() value
+ * not counted in return length as an end marker.
+ * If the file is closed, further calls will reset the
+ * reading position and write the end marker again.
+ *
+ * \return number of characters successfully read
+ */
+static size_t mode_mapread(sauFile *restrict o) {
+	MapRef *ref = o->ref;
+	size_t len = ref->len - ref->pos;
+	// Move to and fill at the first character of the buffer area.
+	o->pos &= (SAU_FILE_BUFSIZ - 1) & ~(SAU_FILE_ALEN - 1);
+	if (len > SAU_FILE_ALEN) len = SAU_FILE_ALEN;
+	memcpy(&o->buf[o->pos], &ref->mem[ref->pos], len);
+	ref->pos += len;
+	if (len < SAU_FILE_ALEN || ref->pos == ref->len)
+		sauFile_end(o, len, false);
+	else
+		o->call_pos = (o->pos + len) & (SAU_FILE_BUFSIZ - 1);
+	return len;
+}
+
+/*
+ * Unmap file without clearing state.
+ */
+static void ref_unmap(sauFile *restrict o) {
+	MapRef *ref = o->ref;
+	if (ref != NULL) {
+		munmap(ref->mem, ref->len);
+		free(ref);
+		o->ref = NULL;
+	}
+}
+#endif
+
 /*
  * Close stdio file without clearing state.
  */
@@ -269,6 +380,21 @@ static void ref_fclose(sauFile *restrict o) {
 	}
 }
 
+/*
+ * Get length of buffer contents from the current position which
+ * can be read in one go, before the call position or buffer end.
+ * Handles callback first if at call position.
+ *
+ * \return length, at least 1
+ */
+static inline size_t span_len(sauFile *restrict o) {
+	sauFile_UPDATE(o);
+	size_t len = sauFile_CREM(o);
+	size_t brem = SAU_FILE_BUFSIZ - o->pos;
+	if (len == 0) len = 1; // as for a single-character read
+	return (len < brem) ? len : brem;
+}
+
 /**
  * Read characters into \p buf. At most \p buf_len - 1 characters
  * are read, and the string is always NULL-terminated.
@@ -373,6 +499,72 @@ bool sauFile_geti(sauFile *restrict o,
 	return !truncate;
 }
 
+/* Largest integer part which can take one more digit exactly in a double. */
+#define GETD_EXACT_MAX ((((uint64_t) 1 << 53) - 9) / 10)
+
+/*
+ * Parse number for sauFile_getd() from contiguous buffer contents,
+ * without per-character position handling. Uses the same arithmetic
+ * in the same order, so that results are identical.
+ *
+ * \return length, 0 if no number, or SIZE_MAX if the number may
+ *         continue past \p span (to be read one character at a time)
+ */
+static size_t getd_span(const uint8_t *restrict str, size_t span,
+		double *restrict var, bool allow_sign,
+		bool *restrict truncate) {
+	const uint8_t *p = str, *end = str + span;
+	double num_a = 0.f, pos_div = 1.f;
+	int64_t num_b = 0;
+	double res;
+	bool minus = false;
+	if (allow_sign && (*p == '+' || *p == '-')) {
+		if (*p == '-') minus = true;
+		if (++p == end) return SIZE_MAX;
+	}
+	if (*p != '.') {
+		if (!SAU_IS_DIGIT(*p)) return 0;
+		/* integer steps below 2^53 are exact, as they are in double */
+		uint64_t num_i = 0;
+		do {
+			num_i = num_i * 10 + (*p - '0');
+			if (++p == end) return SIZE_MAX;
+		} while (SAU_IS_DIGIT(*p) && num_i <= GETD_EXACT_MAX);
+		num_a = (double) num_i;
+		while (SAU_IS_DIGIT(*p)) {
+			num_a = num_a * 10.f + (*p - '0');
+			if (++p == end) return SIZE_MAX;
+		}
+		if (*p != '.') goto DONE;
+		if (p + 1 == end) return SIZE_MAX;
+		if (!SAU_IS_DIGIT(p[1])) {
+#if GETD_ALLOW_TAIL_DOT
+			++p;
+#endif
+			goto DONE;
+		}
+		++p;
+	} else {
+		if (++p == end) return SIZE_MAX;
+		if (!SAU_IS_DIGIT(*p)) return 0;
+	}
+	do {
+		int64_t b = num_b * 10 + (*p - '0');
+		if (num_b <= b) {
+			num_b = b;
+			pos_div *= 10.f; // may become inf
+		}
+		if (++p == end) return SIZE_MAX;
+	} while (SAU_IS_DIGIT(*p));
+	num_a += num_b / pos_div; // importantly, num_b is never inf
+DONE:
+	res = (double) num_a;
+	if (isinf(res)) *truncate = true;
+	if (minus) res = -res;
+	*var = res;
+	return p - str;
+}
+
 /**
  * Read double-precision floating point number into \p var.
  *
@@ -394,7 +586,14 @@ bool sauFile_getd(sauFile *restrict o,
 	double res;
 	bool minus = false;
 	bool truncate = false;
-	size_t len = 0;
+	size_t len = getd_span(&o->buf[o->pos], span_len(o),
+			var, allow_sign, &truncate);
+	if (len != SIZE_MAX) {
+		o->pos += len;
+		if (lenp) *lenp = len;
+		return !truncate;
+	}
+	len = 0;
 	c = sauFile_GETC(o);
 	++len;
 	if (allow_sign && (c == '+' || c == '-')) {
@@ -420,6 +619,7 @@ bool sauFile_getd(sauFile *restrict o,
 			sauFile_INCP(o);
 			goto DONE;
 		}
+		++len;
 #endif
 	} else {
 		c = sauFile_GETC(o);
@@ -475,11 +675,53 @@ size_t sauFile_skipstr(sauFile *restrict o, sauFileFilter_f filter_f) {
 size_t sauFile_skipspace(sauFile *restrict o) {
 	size_t i = 0;
 	for (;;) {
-		uint8_t c = sauFile_GETC(o);
-		if (!SAU_IS_SPACE(c)) break;
-		++i;
+		size_t len = span_len(o);
+		const uint8_t *start = &o->buf[o->pos];
+		const uint8_t *end = start + len, *p = start;
+		while (p < end && SAU_IS_SPACE(*p)) ++p;
+		i += p - start;
+		o->pos += p - start;
+		if (p < end) break;
+	}
+	return i;
+}
+
+#define SWAR_ONES  UINT64_C(0x0101010101010101)
+#define SWAR_HIGHS UINT64_C(0x8080808080808080)
+/* Non-zero if any byte in \p w is less than \p n (up to 128). */
+#define SWAR_HASLESS(w, n) (((w) - SWAR_ONES * (n)) & ~(w) & SWAR_HIGHS)
+/* Non-zero if any byte in \p w equals \p c. */
+#define SWAR_HASBYTE(w, c) SWAR_HASLESS((w) ^ (SWAR_ONES * (c)), 1)
+
+#define SKIPUNTIL_STOP(c, stop_c) \
+	(SAU_IS_LNBRK(c) || (c) == (stop_c) || (c) <= SAU_FILE_MARKER)
+
+/**
+ * Advance past characters until the next is \p stop_c, a linebreak,
+ * or a value which may be an end marker (<= SAU_FILE_MARKER). Looks
+ * at 8 characters at a time where possible, for long stretches of
+ * e.g. comment text.
+ *
+ * \return number of characters skipped
+ */
+size_t sauFile_skipuntil(sauFile *restrict o, uint8_t stop_c) {
+	size_t i = 0;
+	for (;;) {
+		size_t len = span_len(o);
+		const uint8_t *start = &o->buf[o->pos];
+		const uint8_t *end = start + len, *p = start;
+		for (; end - p >= 8; p += 8) {
+			uint64_t w;
+			memcpy(&w, p, 8);
+			if (SWAR_HASBYTE(w, '\n') | SWAR_HASBYTE(w, '\r') |
+			    SWAR_HASBYTE(w, stop_c) |
+			    SWAR_HASLESS(w, SAU_FILE_MARKER + 1)) break;
+		}
+		while (p < end && !SKIPUNTIL_STOP(*p, stop_c)) ++p;
+		i += p - start;
+		o->pos += p - start;
+		if (p < end) break;
 	}
-	sauFile_DECP(o);
 	return i;
 }
 
@@ -491,6 +733,7 @@ size_t sauFile_skipspace(sauFile *restrict o) {
 size_t sauFile_skipline(sauFile *restrict o) {
 	size_t i = 0;
 	for (;;) {
+		i += sauFile_skipuntil(o, '\n');
 		uint8_t c = sauFile_GETC(o);
 		if (SAU_IS_LNBRK(c) ||
 			(c <= SAU_FILE_MARKER && sauFile_AFTER_EOF(o))) break;
@@ -183,6 +183,7 @@ void sauFile_init(sauFile *restrict o,
 		const char *path, sauFileClose_f close_f);
 
 bool sauFile_fopenrb(sauFile *restrict o, const char *restrict path);
+bool sauFile_mapopenrb(sauFile *restrict o, const char *restrict path);
 bool sauFile_stropenrb(sauFile *restrict o,
 		const char *restrict path, const char *restrict str);
 
@@ -384,4 +385,5 @@ bool sauFile_getd(sauFile *restrict o,
 		size_t *restrict lenp);
 size_t sauFile_skipstr(sauFile *restrict o, sauFileFilter_f filter_f);
 size_t sauFile_skipspace(sauFile *restrict o);
+size_t sauFile_skipuntil(sauFile *restrict o, uint8_t stop_c);
 size_t sauFile_skipline(sauFile *restrict o);
@@ -24,9 +24,9 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 
-#define BUF_LEN 1024
-typedef float Buf[BUF_LEN];
+typedef float *Buf; // points to a buffer of the generator block length
 
 struct ParWithRangeMod {
 	sauLine par, r_par;
@@ -106,72 +106,256 @@ typedef struct EventNode {
 	const sauProgramEvent *prg_event;
 } EventNode;
 
+/*
+ * Events copied from a program part when streaming, queued as a list
+ * of such chunks. Each is freed once all its events have been handled.
+ * The operator data for the events follows the array of events.
+ */
+typedef struct EventChunk {
+	struct EventChunk *next;
+	size_t ev_count;
+	sauProgramEvent events[];
+} EventChunk;
+
+/*
+ * Voice event due within the current block, at sample offset \a pos.
+ */
+typedef struct BlockEvent {
+	uint32_t pos;
+	EventNode *e;
+} BlockEvent;
+
+// maximum number of voice events deferred into a block before splitting it
+#define BLOCK_EVENTS_MAX 64
+
 /*
  * Generator flags.
  */
 enum {
-	GEN_OUT_CLEAR = 1<<0,
+	GEN_OUT_CLEAR  = 1<<0,
+	GEN_STREAM     = 1<<1,
+	GEN_STREAM_END = 1<<2,
 };
 
 struct sauGenerator {
 	uint32_t srate;
+	uint32_t block_len;
 	uint16_t gen_flags;
 	uint16_t gen_mix_add_max;
 	Buf *restrict gen_bufs, *restrict mix_bufs;
-	size_t event, ev_count;
+	uint8_t op_nest_depth;
+	size_t event, ev_count, ev_max;
 	EventNode *events;
 	uint32_t event_pos;
-	uint16_t voice, vo_count;
+	uint16_t voice, vo_count, vo_max;
 	VoiceNode *voices;
+	uint32_t block_ev_count;
+	BlockEvent block_events[BLOCK_EVENTS_MAX];
 	float amp_scale;
-	uint32_t op_count;
+	uint32_t op_count, op_max;
 	OperatorNode *operators;
 	sauMempool *mem;
+	/* queue and time position in samples, if streaming */
+	EventChunk *chunk, *last_chunk;
+	size_t chunk_done;
+	uint64_t ev_time, gen_time;
+	int ev_time_carry;
+	uint16_t amp_vo_count;
 };
 
 // maximum number of buffers needed for op nesting depth
 #define COUNT_GEN_BUFS(op_nest_depth) ((1 + (op_nest_depth)) * 7)
 
-static bool alloc_for_program(sauGenerator *restrict o,
+// alignment of node arrays and buffers; cache line size, fits SIMD loads
+#define GEN_ALIGN 64
+
+// buffer length padded to keep each buffer following the first aligned
+#define BUF_STRIDE(block_len) \
+	(((block_len) + (GEN_ALIGN / sizeof(float) - 1)) & \
+	 ~(GEN_ALIGN / sizeof(float) - 1))
+
+/*
+ * Allocate voice and operator nodes for the counts used by \p prg.
+ * When streaming, later parts may use more; each array is then
+ * reallocated, at least doubling in size, keeping the nodes in use.
+ */
+static bool alloc_nodes(sauGenerator *restrict o,
 		const sauProgram *restrict prg) {
 	size_t i;
 
-	i = prg->ev_count;
-	if (i > 0) {
-		o->events = sau_mpalloc(o->mem, i * sizeof(EventNode));
-		if (!o->events) goto ERROR;
-		o->ev_count = i;
-	}
 	i = prg->vo_count;
-	if (i > 0) {
-		o->voices = sau_mpalloc(o->mem, i * sizeof(VoiceNode));
-		if (!o->voices) goto ERROR;
-		o->vo_count = i;
+	if (i > o->vo_max) {
+		if (i < o->vo_max * 2U) i = o->vo_max * 2U;
+		if (i > SAU_PVO_MAX_ID) i = SAU_PVO_MAX_ID;
+		VoiceNode *voices = sau_mpalloc_aligned(o->mem,
+				i * sizeof(VoiceNode), GEN_ALIGN);
+		if (!voices) goto MEM_ERR;
+		if (o->vo_count > 0) memcpy(voices, o->voices,
+				o->vo_count * sizeof(VoiceNode));
+		o->voices = voices;
+		o->vo_max = i;
 	}
+	o->vo_count = prg->vo_count;
 	i = prg->op_count;
-	if (i > 0) {
-		o->operators = sau_mpalloc(o->mem, i * sizeof(OperatorNode));
-		if (!o->operators) goto ERROR;
-		o->op_count = i;
+	if (i > o->op_max) {
+		if (i < o->op_max * 2ULL) i = o->op_max * 2ULL;
+		if (i > SAU_POP_MAX_ID) i = SAU_POP_MAX_ID;
+		OperatorNode *operators = sau_mpalloc_aligned(o->mem,
+				i * sizeof(OperatorNode), GEN_ALIGN);
+		if (!operators) goto MEM_ERR;
+		if (o->op_count > 0) memcpy(operators, o->operators,
+				o->op_count * sizeof(OperatorNode));
+		o->operators = operators;
+		o->op_max = i;
 	}
-	i = COUNT_GEN_BUFS(prg->op_nest_depth);
-	if (i > 0) {
-		o->gen_bufs = calloc(i, sizeof(Buf));
-		if (!o->gen_bufs) goto ERROR;
+	o->op_count = prg->op_count;
+
+	return true;
+MEM_ERR:
+	sau_error("generator", "memory allocation failure");
+	return false;
+}
+
+/*
+ * Allocate scratch buffers for \p op_nest_depth, all of block length.
+ * Allocated together, generator buffers first, followed by the two mix
+ * buffers. When streaming, reallocated if later parts nest deeper.
+ */
+static bool alloc_bufs(sauGenerator *restrict o,
+		uint8_t op_nest_depth, uint32_t block_len) {
+	size_t stride = BUF_STRIDE(block_len);
+	size_t i = COUNT_GEN_BUFS(op_nest_depth) + 2;
+	if (i > SIZE_MAX / sizeof(float) / stride) {
+		sau_error("generator",
+"block length %u too large for %zu buffers", block_len, i);
+		return false;
+	}
+	float *buf_mem = sau_mpalloc_aligned(o->mem,
+			i * stride * sizeof(float), GEN_ALIGN);
+	if (!buf_mem) goto MEM_ERR;
+	o->gen_bufs = sau_mpalloc(o->mem, i * sizeof(Buf));
+	if (!o->gen_bufs) goto MEM_ERR;
+	for (size_t j = 0; j < i; ++j)
+		o->gen_bufs[j] = buf_mem + j * stride;
+	o->mix_bufs = o->gen_bufs + (i - 2);
+	o->gen_mix_add_max = 0; // new mix buffers are clear
+	o->op_nest_depth = op_nest_depth;
+	o->block_len = block_len;
+
+	return true;
+MEM_ERR:
+	sau_error("generator", "memory allocation failure");
+	return false;
+}
+
+static bool alloc_for_program(sauGenerator *restrict o,
+		const sauProgram *restrict prg, uint32_t block_len) {
+	size_t i;
+
+	i = prg->ev_count;
+	if (i > 0 && !(prg->mode & SAU_PMODE_STREAM)) {
+		o->events = sau_mpalloc_aligned(o->mem,
+				i * sizeof(EventNode), GEN_ALIGN);
+		if (!o->events) goto MEM_ERR;
+		o->ev_count = o->ev_max = i;
+	}
+	if (!alloc_nodes(o, prg) ||
+	    !alloc_bufs(o, prg->op_nest_depth, block_len))
+		return false;
+
+	return true;
+MEM_ERR:
+	sau_error("generator", "memory allocation failure");
+	return false;
+}
+
+/*
+ * Free the chunks of events that have all been handled, and move
+ * the rest of the queue to the start of the array, when streaming.
+ */
+static void drop_handled_events(sauGenerator *restrict o) {
+	size_t done = o->event;
+	if (done == 0)
+		return;
+	done += o->chunk_done;
+	while (o->chunk != NULL && o->chunk->ev_count <= done) {
+		EventChunk *chunk = o->chunk;
+		done -= chunk->ev_count;
+		o->chunk = chunk->next;
+		free(chunk);
 	}
-	o->mix_bufs = calloc(2, sizeof(Buf));
-	if (!o->mix_bufs) goto ERROR;
+	if (!o->chunk) o->last_chunk = NULL;
+	o->chunk_done = done;
+	o->ev_count -= o->event;
+	memmove(o->events, &o->events[o->event],
+			o->ev_count * sizeof(EventNode));
+	o->event = 0;
+}
 
+/*
+ * Copy the events of program part \p prg into a new chunk,
+ * and add them to the queue, when streaming.
+ *
+ * \return true, or false on allocation failure
+ */
+static bool queue_events(sauGenerator *restrict o,
+		const sauProgram *restrict prg) {
+	size_t count = prg->ev_count;
+	if (count == 0)
+		return true;
+	drop_handled_events(o);
+	size_t size = sizeof(EventChunk) + count * sizeof(sauProgramEvent);
+	for (size_t i = 0; i < count; ++i)
+		size += prg->events[i].op_data_size;
+	EventChunk *chunk = malloc(size);
+	if (!chunk) goto MEM_ERR;
+	if (o->ev_count + count > o->ev_max) {
+		size_t max = o->ev_max * 2;
+		if (max < o->ev_count + count) max = o->ev_count + count;
+		EventNode *events = realloc(o->events,
+				max * sizeof(EventNode));
+		if (!events) {
+			free(chunk);
+			goto MEM_ERR;
+		}
+		o->events = events;
+		o->ev_max = max;
+	}
+	chunk->next = NULL;
+	chunk->ev_count = count;
+	uint8_t *od = (uint8_t*) &chunk->events[count];
+	for (size_t i = 0; i < count; ++i) {
+		const sauProgramEvent *prg_e = &prg->events[i];
+		sauProgramEvent *chunk_e = &chunk->events[i];
+		EventNode *e = &o->events[o->ev_count++];
+		*chunk_e = *prg_e;
+		chunk_e->op_list = NULL; // only used for printout
+		chunk_e->op_count = 0;
+		chunk_e->op_data = od;
+		memcpy(od, prg_e->op_data, prg_e->op_data_size);
+		od += prg_e->op_data_size;
+		e->wait = sau_ms_in_samples(prg_e->wait_ms, o->srate,
+				&o->ev_time_carry);
+		e->prg_event = chunk_e;
+		o->ev_time += e->wait;
+	}
+	if (!o->last_chunk)
+		o->chunk = chunk;
+	else
+		o->last_chunk->next = chunk;
+	o->last_chunk = chunk;
 	return true;
-ERROR:
+MEM_ERR:
+	sau_error("generator", "memory allocation failure");
 	return false;
 }
 
 static const sauProgramIDArr blank_idarr = {0};
 
 static bool convert_program(sauGenerator *restrict o,
-		const sauProgram *restrict prg, uint32_t srate) {
-	if (!alloc_for_program(o, prg))
+		const sauProgram *restrict prg, uint32_t srate,
+		uint32_t block_len) {
+	if (!alloc_for_program(o, prg, block_len))
 		return false;
 
 	/*
@@ -183,6 +367,12 @@ static bool convert_program(sauGenerator *restrict o,
 	o->amp_scale = 0.5f * prg->ampmult; // half for panning sum
 	if ((prg->mode & SAU_PMODE_AMP_DIV_VOICES) != 0)
 		o->amp_scale /= o->vo_count;
+	if ((prg->mode & SAU_PMODE_STREAM) != 0) {
+		o->gen_flags |= GEN_STREAM;
+		if ((prg->mode & SAU_PMODE_AMP_DIV_VOICES) != 0)
+			o->amp_vo_count = o->vo_count;
+		return queue_events(o, prg);
+	}
 	for (size_t i = 0; i < prg->ev_count; ++i) {
 		const sauProgramEvent *prg_e = &prg->events[i];
 		EventNode *e = &o->events[i];
@@ -195,20 +385,38 @@ static bool convert_program(sauGenerator *restrict o,
 }
 
 /**
- * Create instance for program \p prg and sample rate \p srate.
+ * Create instance for program \p prg and sample rate \p srate,
+ * generating audio in blocks of up to \p block_len samples.
+ * If \p block_len is zero, SAU_GEN_BLOCK_LEN_DEFAULT is used.
+ *
+ * If \p prg is the first part of a program being streamed, the
+ * events are copied, and further parts are to be added using
+ * sauGenerator_add_part(). Amplitude scaling is fixed by the first.
+ *
+ * \return instance, or NULL on error
  */
 sauGenerator* sau_create_Generator(const sauProgram *restrict prg,
-		uint32_t srate) {
+		uint32_t srate, uint32_t block_len) {
+	if (block_len == 0)
+		block_len = SAU_GEN_BLOCK_LEN_DEFAULT;
+	if (block_len < SAU_GEN_BLOCK_LEN_MIN ||
+	    block_len > SAU_GEN_BLOCK_LEN_MAX) {
+		sau_error("generator",
+"block length %u outside range %u-%u", block_len,
+				SAU_GEN_BLOCK_LEN_MIN, SAU_GEN_BLOCK_LEN_MAX);
+		return NULL;
+	}
 	sauMempool *mem = sau_create_Mempool(0);
 	if (!mem)
 		return NULL;
-	sauGenerator *o = sau_mpalloc(mem, sizeof(sauGenerator));
+	sauGenerator *o = sau_mpalloc_aligned(mem,
+			sizeof(sauGenerator), GEN_ALIGN);
 	if (!o) {
 		sau_destroy_Mempool(mem);
 		return NULL;
 	}
 	o->mem = mem;
-	if (!convert_program(o, prg, srate)) {
+	if (!convert_program(o, prg, srate, block_len)) {
 		sau_destroy_Generator(o);
 		return NULL;
 	}
@@ -222,11 +430,78 @@ sauGenerator* sau_create_Generator(const sauProgram *restrict prg,
 void sau_destroy_Generator(sauGenerator *restrict o) {
 	if (!o)
 		return;
-	free(o->gen_bufs);
-	free(o->mix_bufs);
+	if ((o->gen_flags & GEN_STREAM) != 0) {
+		EventChunk *chunk = o->chunk;
+		while (chunk != NULL) {
+			EventChunk *next = chunk->next;
+			free(chunk);
+			chunk = next;
+		}
+		free(o->events);
+	}
 	sau_destroy_Mempool(o->mem);
 }
 
+/**
+ * Add the next part of a program being streamed, following the part
+ * the instance was created with. The events are copied into a queue,
+ * and dropped once handled. When a part lacking SAU_PMODE_STREAM has
+ * been added, no more are expected, and the signal may end.
+ *
+ * \return true, or false on error
+ */
+bool sauGenerator_add_part(sauGenerator *restrict o,
+		const sauProgram *restrict prg) {
+	if ((o->gen_flags & (GEN_STREAM | GEN_STREAM_END)) != GEN_STREAM) {
+		sau_error("generator", "program part added when not streaming");
+		return false;
+	}
+	if (!alloc_nodes(o, prg))
+		return false;
+	if (prg->op_nest_depth > o->op_nest_depth &&
+	    !alloc_bufs(o, prg->op_nest_depth, o->block_len))
+		return false;
+	if (o->amp_vo_count > 0 && o->vo_count > o->amp_vo_count) {
+		sau_warning("generator",
+"voice count rose to %hu from %hu while streaming; amplitude not rescaled",
+				o->vo_count, o->amp_vo_count);
+		o->amp_vo_count = 0; // warn only once
+	}
+	if (!queue_events(o, prg))
+		return false;
+	if (!(prg->mode & SAU_PMODE_STREAM))
+		o->gen_flags |= GEN_STREAM_END;
+	return true;
+}
+
+/**
+ * Get the number of samples which can be generated before the next
+ * part of a program being streamed is needed, or SIZE_MAX if all of
+ * the program is available.
+ *
+ * Using only full calls to sauGenerator_run() while streaming, each
+ * within this length, the output is the same as without streaming.
+ */
+size_t sauGenerator_ahead_len(const sauGenerator *restrict o) {
+	if ((o->gen_flags & (GEN_STREAM | GEN_STREAM_END)) != GEN_STREAM)
+		return SIZE_MAX;
+	if (o->ev_time <= o->gen_time)
+		return 0;
+	uint64_t len = o->ev_time - o->gen_time;
+	return (len < SIZE_MAX) ? len : SIZE_MAX - 1;
+}
+
+/**
+ * Get memory statistics for instance.
+ */
+void sauGenerator_get_mem_stats(const sauGenerator *restrict o,
+		sauGeneratorMemStats *restrict st) {
+	size_t buf_size = sizeof(float) * BUF_STRIDE(o->block_len);
+	sau_mp_stats(o->mem, &st->pool);
+	st->gen_bufs = buf_size * (o->mix_bufs - o->gen_bufs);
+	st->mix_bufs = buf_size * 2;
+}
+
 /*
  * Set voice duration according to the current list of operators.
  */
@@ -357,12 +632,15 @@ static void handle_event(sauGenerator *restrict o, EventNode *restrict e) {
 		VoiceNode *vn = NULL;
 		if (pe->vo_id != SAU_PVO_NO_ID)
 			vn = &o->voices[pe->vo_id];
+		const uint8_t *od_src = pe->op_data;
 		for (size_t i = 0; i < pe->op_data_count; ++i) {
-			const sauProgramOpData *od = &pe->op_data[i];
-			OperatorNode *n = &o->operators[od->id];
-			if (!(n->gen.flags & ON_INIT))
-				prepare_op(o, n, vn, od);
-			update_op(o, n, od);
+			sauProgramOpData od;
+			od_src = sauProgramOpData_decode(&od, od_src);
+			OperatorNode *n = &o->operators[od.id];
+			if (!(n->gen.flags & ON_INIT) ||
+			    (od.params & SAU_POPP_INIT) != 0)
+				prepare_op(o, n, vn, &od);
+			update_op(o, n, &od);
 		}
 		if (vn) {
 			vn->carr_op_id = pe->carr_op_id;
@@ -655,10 +933,7 @@ static void run_block_rasg(sauGenerator *restrict o,
 		sauRasG_run_selfmod(&n->rg.rasg, len, rasg_buf,
 				cycle_buf, selfmod);
 	} else {
-		float *tmp_buf = *(bufs + 0); // #6
-		float *tmp2_buf = *(bufs + 1); // #7
-		sauRasG_run(&n->rg.rasg, len, rasg_buf, tmp_buf, tmp2_buf,
-				cycle_buf);
+		sauRasG_run(&n->rg.rasg, len, rasg_buf, cycle_buf);
 	}
 	block_mix(&n->rg.osc.gen, mix_buf, len, wave_env, layer, rasg_buf, amp);
 }
@@ -741,18 +1016,19 @@ static void mix_clear(sauGenerator *restrict o) {
 
 /*
  * Add output for voice node \p vn into the mix buffers
- * (0 = left, 1 = right) from the first generator buffer.
+ * (0 = left, 1 = right) from the first generator buffer,
+ * starting at position \p pos in the mix buffers.
  *
  * The second generator buffer is used for panning if dynamic panning
  * is used.
  */
 static void mix_add(sauGenerator *restrict o,
 		OperatorNode *restrict n,
-		VoiceNode *restrict vn, uint32_t len) {
+		VoiceNode *restrict vn, uint32_t pos, uint32_t len) {
 	float *s_buf = o->gen_bufs[0];
 	float *pan_buf = NULL;
-	float *mix_l = o->mix_bufs[0];
-	float *mix_r = o->mix_bufs[1];
+	float *mix_l = o->mix_bufs[0] + pos;
+	float *mix_r = o->mix_bufs[1] + pos;
 	if (n->gen.pan.flags & SAU_LINEP_GOAL ||
 	    n->gen.camods->count > 0) {
 		pan_buf = o->gen_bufs[1 + vn->freq_buf_id];
@@ -784,7 +1060,7 @@ static void mix_add(sauGenerator *restrict o,
 			mix_r[i] += s + s_r;
 		}
 	}
-	if (o->gen_mix_add_max < len) o->gen_mix_add_max = len;
+	if (o->gen_mix_add_max < pos + len) o->gen_mix_add_max = pos + len;
 }
 
 /**
@@ -825,56 +1101,113 @@ static void mix_write_stereo(sauGenerator *restrict o,
 }
 
 /*
- * Generate up to BUF_LEN samples for a voice, mixed into the
- * mix buffers.
+ * Generate samples for a voice from position \p pos up to \p len
+ * in the current block, mixed into the mix buffers.
  *
- * \return number of samples generated
+ * \return end position of samples generated, or zero if none
  */
 static uint32_t run_voice(sauGenerator *restrict o,
-		VoiceNode *restrict vn, uint32_t len) {
+		VoiceNode *restrict vn, uint32_t pos, uint32_t len) {
 	OperatorNode *n = &o->operators[vn->carr_op_id];
 	uint32_t time = vn->duration, out_len = 0;
-	if (len > BUF_LEN) len = BUF_LEN;
+	len -= pos;
 	if (time > len) time = len;
 	if (n->gen.time > 0)
 		out_len = run_block(o, o->gen_bufs, time, n,
 				NULL, false, false);
-	if (out_len > 0)
-		mix_add(o, n, vn, out_len);
 	vn->duration -= time;
-	return out_len;
+	if (out_len == 0)
+		return 0;
+	mix_add(o, n, vn, pos, out_len);
+	return pos + out_len;
 }
 
 /*
- * Run voices for \p time, repeatedly generating up to BUF_LEN samples
- * and writing them into the 16-bit interleaved channels buffer \p buf.
+ * Handle events due at the start of the block, and gather those due
+ * for voices later within the block of \p len samples into the block
+ * events list, to be applied by run_block_voices() at their offsets.
+ *
+ * Events without a voice are not deferred, as they may affect any
+ * voice; the block is instead shortened to end where one is due.
+ *
+ * \return length of block to process, no greater than \p len
+ */
+static uint32_t prepare_block_events(sauGenerator *restrict o,
+		uint32_t len) {
+	uint32_t count = 0, pos = 0;
+	while (o->event < o->ev_count) {
+		EventNode *e = &o->events[o->event];
+		if (o->event_pos < e->wait)
+			break;
+		handle_event(o, e);
+		++o->event;
+		o->event_pos = 0;
+	}
+	for (size_t i = o->event; i < o->ev_count; ++i) {
+		EventNode *e = &o->events[i];
+		pos = (count == 0) ? (e->wait - o->event_pos) : (pos + e->wait);
+		if (pos >= len)
+			break;
+		if (e->prg_event->vo_id == SAU_PVO_NO_ID ||
+		    count == BLOCK_EVENTS_MAX) {
+			/*
+			 * Split block, leaving events at the new end
+			 * to be handled first in the next block.
+			 */
+			len = pos;
+			while (count > 0 && o->block_events[count - 1].pos >= len)
+				--count;
+			break;
+		}
+		o->block_events[count++] = (BlockEvent){pos, e};
+	}
+	o->block_ev_count = count;
+	o->event += count;
+	if (count > 0)
+		o->event_pos = len - o->block_events[count - 1].pos;
+	else
+		o->event_pos += len;
+	return len;
+}
+
+/*
+ * Run voices for a block of \p len samples, into the mix buffers,
+ * applying the gathered block events for each voice at their offsets.
+ * Only the voices which have events within the block are split into
+ * shorter runs; the others each generate the whole block in one run.
  *
  * \return number of samples generated
  */
-static uint32_t run_for_time(sauGenerator *restrict o,
-		uint32_t time, int16_t *restrict buf, bool stereo) {
-	int16_t *sp = buf;
-	uint32_t gen_len = 0;
-	while (time > 0) {
-		uint32_t len = (time < BUF_LEN) ? time : BUF_LEN;
-		time -= len;
-		mix_clear(o);
-		uint32_t last_len = 0;
-		for (uint32_t i = o->voice; i < o->vo_count; ++i) {
-			VoiceNode *vn = &o->voices[i];
-			if (vn->duration != 0) {
-				uint32_t voice_len = run_voice(o, vn, len);
+static uint32_t run_block_voices(sauGenerator *restrict o, uint32_t len) {
+	const BlockEvent *bev = o->block_events;
+	uint32_t bev_count = o->block_ev_count;
+	uint32_t last_len = 0;
+	uint16_t first_voice = o->voice;
+	for (uint32_t j = 0; j < bev_count; ++j) {
+		uint16_t vo_id = bev[j].e->prg_event->vo_id;
+		if (first_voice > vo_id) first_voice = vo_id;
+	}
+	for (uint32_t i = first_voice; i < o->vo_count; ++i) {
+		VoiceNode *vn = &o->voices[i];
+		uint32_t pos = 0, voice_len;
+		for (uint32_t j = 0; j < bev_count; ++j) {
+			EventNode *e = bev[j].e;
+			if (e->prg_event->vo_id != i)
+				continue;
+			if (vn->duration != 0 && pos < bev[j].pos) {
+				voice_len = run_voice(o, vn, pos, bev[j].pos);
 				if (voice_len > last_len) last_len = voice_len;
 			}
+			handle_event(o, e);
+			pos = bev[j].pos;
 		}
-		if (last_len > 0) {
-			gen_len += last_len;
-			(stereo ?
-			 mix_write_stereo :
-			 mix_write_mono)(o, &sp, last_len);
+		if (vn->duration != 0) {
+			voice_len = run_voice(o, vn, pos, len);
+			if (voice_len > last_len) last_len = voice_len;
 		}
 	}
-	return gen_len;
+	o->block_ev_count = 0;
+	return last_len;
 }
 
 /*
@@ -907,46 +1240,36 @@ bool sauGenerator_run(sauGenerator *restrict o,
 		size_t *restrict out_len) {
 	int16_t *sp = buf;
 	uint32_t len = buf_len;
-	uint32_t skip_len, last_len, gen_len = 0;
+	uint32_t pos = 0, gen_len = 0;
 	if (!(o->gen_flags & GEN_OUT_CLEAR)) {
 		o->gen_flags |= GEN_OUT_CLEAR;
 		memset(buf, 0, sizeof(int16_t) * (stereo ? len * 2 : len));
 	}
-PROCESS:
-	skip_len = 0;
-	while (o->event < o->ev_count) {
-		EventNode *e = &o->events[o->event];
-		if (o->event_pos < e->wait) {
+	while (pos < len) {
+		uint32_t block_len = len - pos;
+		if (block_len > o->block_len) block_len = o->block_len;
+		size_t prev_event = o->event;
+		block_len = prepare_block_events(o, block_len);
+		if (o->event != prev_event) {
 			/*
-			 * Limit voice running len to waittime.
-			 *
-			 * Split processing into two blocks when needed to
-			 * ensure event handling runs before voices.
+			 * Count time up to the last event handled as generated.
 			 */
-			uint32_t waittime = e->wait - o->event_pos;
-			if (waittime < len) {
-				skip_len = len - waittime;
-				len = waittime;
-			}
-			o->event_pos += len;
-			break;
+			uint32_t ev_end = pos + ((o->block_ev_count > 0) ?
+				o->block_events[o->block_ev_count - 1].pos : 0);
+			if (gen_len < ev_end) gen_len = ev_end;
 		}
-		handle_event(o, e);
-		++o->event;
-		o->event_pos = 0;
-	}
-	last_len = run_for_time(o, len, sp, stereo);
-	if (skip_len > 0) {
-		gen_len += len;
-		if (stereo)
-			sp += len * 2;
-		else
-			sp += len;
-		len = skip_len;
-		goto PROCESS;
-	} else {
-		gen_len += last_len;
+		mix_clear(o);
+		uint32_t last_len = run_block_voices(o, block_len);
+		if (last_len > 0) {
+			sp = buf + (stereo ? pos * 2 : pos);
+			(stereo ?
+			 mix_write_stereo :
+			 mix_write_mono)(o, &sp, last_len);
+			if (gen_len < pos + last_len) gen_len = pos + last_len;
+		}
+		pos += block_len;
 	}
+	o->gen_time += len;
 	/*
 	 * Advance starting voice and check for end of signal.
 	 */
@@ -954,6 +1277,8 @@ PROCESS:
 		VoiceNode *vn;
 		if (o->voice == o->vo_count) {
 			if (o->event != o->ev_count) break;
+			if ((o->gen_flags & (GEN_STREAM | GEN_STREAM_END)) ==
+			    GEN_STREAM) break; // more to come
 			/*
 			 * The end.
 			 */
@@ -971,3 +1296,49 @@ PROCESS:
 	if (out_len) *out_len = buf_len;
 	return true;
 }
+
+/* block lengths tried by sau_tune_Generator(), default first */
+static const uint32_t tune_block_lens[] = {
+	SAU_GEN_BLOCK_LEN_DEFAULT, 256, 512, 2048, 4096, 0
+};
+
+// maximum time of audio to generate per block length tried
+#define TUNE_TIME_MS 1000
+
+/**
+ * Benchmark generation for program \p prg at sample rate \p srate
+ * with a few block lengths, for up to TUNE_TIME_MS of audio each,
+ * calling sauGenerator_run() with \p buf_len and \p stereo as for
+ * actual use. Picks the fastest, or the default length on a tie.
+ *
+ * \return block length, or zero on error
+ */
+uint32_t sau_tune_Generator(const sauProgram *restrict prg,
+		uint32_t srate, size_t buf_len, bool stereo) {
+	uint32_t max_len = sau_ms_in_samples(TUNE_TIME_MS, srate, NULL);
+	int16_t *buf = calloc(stereo ? buf_len * 2 : buf_len,
+			sizeof(int16_t));
+	uint32_t best_len = 0;
+	clock_t best_time = 0;
+	if (!buf)
+		return 0;
+	for (const uint32_t *lenp = tune_block_lens; *lenp != 0; ++lenp) {
+		uint32_t block_len = *lenp;
+		sauGenerator *o = sau_create_Generator(prg, srate, block_len);
+		if (!o)
+			break;
+		clock_t start = clock();
+		for (uint32_t pos = 0; pos < max_len; pos += buf_len) {
+			if (!sauGenerator_run(o, buf, buf_len, stereo, NULL))
+				break;
+		}
+		clock_t time = clock() - start;
+		sau_destroy_Generator(o);
+		if (best_len == 0 || time < best_time) {
+			best_len = block_len;
+			best_time = time;
+		}
+	}
+	free(buf);
+	return best_len;
+}
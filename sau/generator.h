@@ -14,13 +14,37 @@
 #pragma once
 #include "program.h"
 
+/* Generator block length (samples per run of each voice), range allowed. */
+#define SAU_GEN_BLOCK_LEN_DEFAULT 1024
+#define SAU_GEN_BLOCK_LEN_MIN     16
+#define SAU_GEN_BLOCK_LEN_MAX     16384
+
 struct sauGenerator;
 typedef struct sauGenerator sauGenerator;
 
 sauGenerator* sau_create_Generator(const sauProgram *restrict prg,
-		uint32_t srate) sauMalloclike;
+		uint32_t srate, uint32_t block_len) sauMalloclike;
 void sau_destroy_Generator(sauGenerator *restrict o);
 
+uint32_t sau_tune_Generator(const sauProgram *restrict prg,
+		uint32_t srate, size_t buf_len, bool stereo);
+
 bool sauGenerator_run(sauGenerator *restrict o,
 		int16_t *restrict buf, size_t buf_len, bool stereo,
 		size_t *restrict out_len);
+
+bool sauGenerator_add_part(sauGenerator *restrict o,
+		const sauProgram *restrict prg);
+size_t sauGenerator_ahead_len(const sauGenerator *restrict o);
+
+/**
+ * Generator memory statistics. Buffer sizes are in bytes.
+ */
+typedef struct sauGeneratorMemStats {
+	sauMempoolStats pool; // all generator data, including buffers
+	size_t gen_bufs; // scratch buffers for operator nesting depth
+	size_t mix_bufs; // buffers for mixing voices into output
+} sauGeneratorMemStats;
+
+void sauGenerator_get_mem_stats(const sauGenerator *restrict o,
+		sauGeneratorMemStats *restrict st);
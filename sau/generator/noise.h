@@ -38,13 +38,23 @@ static inline void sauNoiseG_set_noise(sauNoiseG *restrict o, uint8_t noise) {
 typedef void (*sauNoiseG_run_f)(sauNoiseG *restrict o,
 		float *restrict buf, size_t len);
 
-static sauMaybeUnused void sauNoiseG_run_wh(sauNoiseG *restrict o,
+/*
+ * The noise functions are written to evaluate the random access noise
+ * function for many indices in parallel, using straight loops which are
+ * auto-vectorized. Where a sample depends on the previous, the loop is
+ * split into passes over chunks, keeping the serial part minimal.
+ */
+#define NOISE_CHUNK 256
+
+static sauMaybeUnused sauSIMDclones void sauNoiseG_run_wh(sauNoiseG *restrict o,
 		float *restrict buf, size_t len) {
 	const float scale = 0x1p-31;
+	const uint32_t n = o->n;
 	for (size_t i = 0; i < len; ++i) {
-		uint32_t s = sau_ranfast32(o->n++);
+		uint32_t s = sau_ranfast32(n + (uint32_t) i);
 		buf[i] = sau_fscalei(s, scale);
 	}
+	o->n = n + len;
 }
 
 /*
@@ -97,34 +107,73 @@ static inline float sau_franssgauss32(uint32_t n) {
 	return b;
 }
 
+/**
+ * Random access soft-saturated Gaussian noise, using approximation,
+ * for both values of the pair for index \p n. The first value is the
+ * same as returned by sau_franssgauss32(), the second value uses cos()
+ * in place of sin(), with the sign from another bit.
+ */
+static inline void sau_franssgauss32_pair(uint32_t n,
+		float *restrict s_out, float *restrict c_out) {
+	int32_t s0 = sau_ranfast32(n);
+	int32_t s1 = sau_mcg32(s0);
+	float a = s0 * 0x1p-32;
+	float b = s1 * 0x1p-32;
+	float c = ssgauss_dist4(soft_sqrtm2logp1_2_r01(a));
+	float c_signed = (s0 & (1<<12)) ? -c : c;
+	*s_out = c * sau_sinpi_d5f(b);
+	*c_out = c_signed * sau_sinpi_d5f(0.5f - fabsf(b));
+}
+
 /*
- * Uses soft-saturated Gaussian function.
- *
- * Would be more effiicent to retain both outputs rather than just one.
+ * Uses soft-saturated Gaussian function, retaining both outputs,
+ * with each value pair for the index halved.
  */
-static sauMaybeUnused void sauNoiseG_run_gw(sauNoiseG *restrict o,
+static sauMaybeUnused sauSIMDclones void sauNoiseG_run_gw(sauNoiseG *restrict o,
 		float *restrict buf, size_t len) {
-	for (size_t i = 0; i < len; ++i) {
-		buf[i] = sau_franssgauss32(o->n++);
+	const uint32_t n = o->n;
+	size_t i = 0;
+	float s, c;
+	if (len == 0)
+		return;
+	if (n & 1) {
+		sau_franssgauss32_pair(n >> 1, &s, &c);
+		buf[i++] = c;
+	}
+	const uint32_t pair_n = (n + i) >> 1;
+	const size_t pairs = (len - i) / 2;
+	for (size_t j = 0; j < pairs; ++j) {
+		sau_franssgauss32_pair(pair_n + (uint32_t) j, &s, &c);
+		buf[i + j*2] = s;
+		buf[i + j*2 + 1] = c;
+	}
+	i += pairs * 2;
+	if (i < len) {
+		sau_franssgauss32_pair(pair_n + pairs, &s, &c);
+		buf[i] = s;
 	}
+	o->n = n + len;
 }
 
-static sauMaybeUnused void sauNoiseG_run_bw(sauNoiseG *restrict o,
+static sauMaybeUnused sauSIMDclones void sauNoiseG_run_bw(sauNoiseG *restrict o,
 		float *restrict buf, size_t len) {
+	const uint32_t n = o->n;
 	for (size_t i = 0; i < len; ++i) {
-		uint32_t n = o->n++;
-		int32_t s = sau_sar32(sau_ranfast32(n), 31) * 2 + 1;
+		int32_t s = sau_sar32(sau_ranfast32(n + (uint32_t) i), 31) * 2 + 1;
 		buf[i] = s;
 	}
+	o->n = n + len;
 }
 
-static sauMaybeUnused void sauNoiseG_run_tw(sauNoiseG *restrict o,
+static sauMaybeUnused sauSIMDclones void sauNoiseG_run_tw(sauNoiseG *restrict o,
 		float *restrict buf, size_t len) {
+	const uint32_t n = o->n;
 	for (size_t i = 0; i < len; ++i) {
-		uint32_t n = o->n++;
-		int32_t s = sau_sar32(sau_ranfast32(n), 31) * 2 + 1;
-		buf[i] = (n & 1) ? s : 0.f;
+		uint32_t n_i = n + (uint32_t) i;
+		int32_t s = sau_sar32(sau_ranfast32(n_i), 31) * 2 + 1;
+		buf[i] = (n_i & 1) ? s : 0.f;
 	}
+	o->n = n + len;
 }
 
 /*
@@ -132,43 +181,74 @@ static sauMaybeUnused void sauNoiseG_run_tw(sauNoiseG *restrict o,
  * discontinuities with wavefolding. Wavwfolding blends in with 6 dB
  * per octave roll-off. This makes the signal maximally bassy at the
  * very-low frequency end. As loud as a DC-blocker version would be.
+ *
+ * Steps are made in parallel, summed serially, then folded in parallel.
  */
-static sauMaybeUnused void sauNoiseG_run_re(sauNoiseG *restrict o,
+static sauMaybeUnused sauSIMDclones void sauNoiseG_run_re(sauNoiseG *restrict o,
 		float *restrict buf, size_t len) {
 	const float scale = 0x1p-31;
+	const uint32_t n = o->n;
 	uint32_t sum = o->prev;
-	for (size_t i = 0; i < len; ++i) {
-		int32_t s = sau_ranfast32(o->n++);
-		sum += (s >> 6); // 5 alternatively makes a louder version
-		s = sau_foldhd32(sum);
-		buf[i] = sau_fscalei(s, scale);
+	uint32_t sums[NOISE_CHUNK];
+	for (size_t i = 0; i < len; i += NOISE_CHUNK) {
+		size_t chunk_len = len - i;
+		if (chunk_len > NOISE_CHUNK) chunk_len = NOISE_CHUNK;
+		for (size_t j = 0; j < chunk_len; ++j) {
+			int32_t s = sau_ranfast32(n + (uint32_t) (i + j));
+			sums[j] = (s >> 6); // 5 alternatively makes a louder version
+		}
+		for (size_t j = 0; j < chunk_len; ++j)
+			sums[j] = sum += sums[j];
+		for (size_t j = 0; j < chunk_len; ++j) {
+			int32_t s = sau_foldhd32(sums[j]);
+			buf[i + j] = sau_fscalei(s, scale);
+		}
 	}
 	o->prev = sum;
+	o->n = n + len;
 }
 
-static sauMaybeUnused void sauNoiseG_run_vi(sauNoiseG *restrict o,
+static sauMaybeUnused sauSIMDclones void sauNoiseG_run_vi(sauNoiseG *restrict o,
 		float *restrict buf, size_t len) {
 	const float scale = 0x1p-31;
-	uint32_t s0 = o->prev;
-	for (size_t i = 0; i < len; ++i) {
-		uint32_t s1 = sau_ranfast32(o->n++);
-		buf[i] = sau_fscalei((s1 / 2) - (s0 / 2), scale);
-		s0 = s1;
+	const uint32_t n = o->n;
+	uint32_t s[NOISE_CHUNK + 1];
+	s[NOISE_CHUNK] = o->prev;
+	for (size_t i = 0; i < len; i += NOISE_CHUNK) {
+		size_t chunk_len = len - i;
+		if (chunk_len > NOISE_CHUNK) chunk_len = NOISE_CHUNK;
+		s[0] = s[NOISE_CHUNK];
+		for (size_t j = 0; j < chunk_len; ++j)
+			s[j + 1] = sau_ranfast32(n + (uint32_t) (i + j));
+		for (size_t j = 0; j < chunk_len; ++j)
+			buf[i + j] = sau_fscalei((s[j + 1] / 2) - (s[j] / 2),
+					scale);
+		s[NOISE_CHUNK] = s[chunk_len];
 	}
-	o->prev = s0;
+	o->prev = s[NOISE_CHUNK];
+	o->n = n + len;
 }
 
-static sauMaybeUnused void sauNoiseG_run_bv(sauNoiseG *restrict o,
+static sauMaybeUnused sauSIMDclones void sauNoiseG_run_bv(sauNoiseG *restrict o,
 		float *restrict buf, size_t len) {
-	int32_t s0 = o->prev;
-	for (size_t i = 0; i < len; ++i) {
-		uint32_t n = o->n++;
-		int32_t s1 = sau_sar32(sau_ranfast32(n), 31);
-		s1 = (n & 1) ? (s1 * 2 + 1) : 0;
-		buf[i] = (s1 - s0);
-		s0 = s1;
+	const uint32_t n = o->n;
+	int32_t s[NOISE_CHUNK + 1];
+	s[NOISE_CHUNK] = o->prev;
+	for (size_t i = 0; i < len; i += NOISE_CHUNK) {
+		size_t chunk_len = len - i;
+		if (chunk_len > NOISE_CHUNK) chunk_len = NOISE_CHUNK;
+		s[0] = s[NOISE_CHUNK];
+		for (size_t j = 0; j < chunk_len; ++j) {
+			uint32_t n_j = n + (uint32_t) (i + j);
+			int32_t s1 = sau_sar32(sau_ranfast32(n_j), 31);
+			s[j + 1] = (n_j & 1) ? (s1 * 2 + 1) : 0;
+		}
+		for (size_t j = 0; j < chunk_len; ++j)
+			buf[i + j] = (s[j + 1] - s[j]);
+		s[NOISE_CHUNK] = s[chunk_len];
 	}
-	o->prev = s0;
+	o->prev = s[NOISE_CHUNK];
+	o->n = n + len;
 }
 
 #define SAU_NOISE__X_CASE(NAME) \
@@ -223,87 +223,41 @@ static sauMaybeUnused void sauCyclor_fill(sauCyclor *restrict o,
 
 #undef P /* done */
 
-typedef void (*sauRasG_map_f)(sauRasG *restrict o,
-		size_t buf_len,
-		float *restrict end_a_buf,
-		float *restrict end_b_buf,
-		const uint32_t *restrict cycle_buf);
-
-typedef void (*sauRasG_map_selfmod_f)(sauRasG *restrict o,
-		size_t buf_len,
-		float *restrict main_buf,
-		sauLine_val_f line_f,
-		const uint32_t *restrict cycle_buf,
-		const float *restrict pm_abuf);
-
 /*
- * Define loop body for a sauRasg_map_*_s() function. Expects named macro.
+ * Random function variants, each named after a RASG_MAP_*() body below.
+ * Each body uses \a cycle to set the line segment end values \a a and \a b,
+ * and may use the level \a sr and other options from \a o.
  */
-#define RASG_MAP_S_LOOP(loop_for_func) \
-unsigned flags = o->opt.flags, line = o->opt.line; \
-const float perlin_amp = \
-	(flags & (SAU_RAS_O_HALFSHAPE|SAU_RAS_O_ZIGZAG)) ? \
-	1.f : \
-	sauLine_coeffs[line].perlin_amp; \
-for (size_t i = 0; i < buf_len; ++i) { \
-	float pm_a = o->fb_s * pm_abuf[i] * 0.5f; \
-	float phase = main_buf[i] + pm_a; \
-	int32_t cycle_adj = floorf(phase); \
-	uint32_t cycle = cycle_buf[i] + cycle_adj; \
-	phase -= cycle_adj; \
-	/**/ RASG_MAP_##loop_for_func \
-	if (flags & SAU_RAS_O_PERLIN) { \
-		a *= perlin_amp*phase; \
-		b *= perlin_amp*(phase-1.f); \
-	} \
-	if (flags & SAU_RAS_O_HALFSHAPE) { \
-		/* sort value-pairs, for a decreasing sawtooth-like waveform */\
-		float max = sau_maxf(a, b); \
-		float min = sau_minf(a, b); \
-		a = max; \
-		b = min; \
-	} \
-	if (flags & SAU_RAS_O_ZIGZAG) { \
-		/* swap half-cycle ends for jagged shape on random amplitude */\
-		float tmp = a; a = b; b = tmp; \
-	} \
-	if (flags & SAU_RAS_O_SQUARE) { \
-		/* square keeping sign; value uniformity to energy uniformity*/\
-		a *= fabsf(a); \
-		b *= fabsf(b); \
-	} \
-	float s = line_f(phase, a, b); \
-	main_buf[i] = s; \
-	/* Suppress ringing using 1-pole filter + 1-zero filter. */ \
-	o->fb_s = (o->fb_s + s + o->prev_s) * 0.5f; \
-	o->prev_s = s; \
-}
+#define RASG__MAP_ITEMS(X, ...) \
+	X(urand, __VA_ARGS__) \
+	X(v_urand, __VA_ARGS__) \
+	X(gauss, __VA_ARGS__) \
+	X(bin, __VA_ARGS__) \
+	X(v_bin, __VA_ARGS__) \
+	X(tern, __VA_ARGS__) \
+	X(fixed, __VA_ARGS__) \
+	X(v_fixed, __VA_ARGS__) \
+	X(fixed_simple, __VA_ARGS__) \
+	X(addrec, __VA_ARGS__) \
+	//
+#define RASG__X_ID(NAME, ...) RASG_MAP_N_##NAME,
+
+enum {
+	RASG__MAP_ITEMS(RASG__X_ID, )
+	RASG_MAP_NAMED
+};
 
 /*
- * Define a whole sauRasg_map_*_s() function. Expects named macro.
+ * 'Uniform random' mode.
  */
-#define RASG_MAP_S_FUNC(loop_for_func) \
-static sauMaybeUnused void sauRasG_map_##loop_for_func##_s(sauRasG *restrict o,\
-		size_t buf_len, \
-		float *restrict main_buf, \
-		sauLine_val_f line_f, \
-		const uint32_t *restrict cycle_buf, \
-		const float *restrict pm_abuf) { \
-	int sauMaybeUnused sr = o->opt.level; \
-	RASG_MAP_S_LOOP(loop_for_func) \
-}
+#define RASG_MAP_urand \
+		float a = sau_fscalei(sau_ranfast32(cycle), 0x1p-31f); \
+		float b = sau_fscalei(sau_ranfast32(cycle + 1), 0x1p-31f); \
+/**/
 
-/**
- * Run for \p buf_len samples in 'violet random' mode, generating output.
+/*
+ * 'Violet random' mode.
  */
-static sauMaybeUnused void sauRasG_map_v_urand(sauRasG *restrict o,
-		size_t buf_len,
-		float *restrict end_a_buf,
-		float *restrict end_b_buf,
-		const uint32_t *restrict cycle_buf) {
-	(void)o;
-	for (size_t i = 0; i < buf_len; ++i) {
-		uint32_t cycle = cycle_buf[i];
 #define RASG_MAP_v_urand \
 		uint32_t s0 = sau_ranfast32(cycle - 1) / 2; \
 		uint32_t s1 = sau_ranfast32(cycle) / 2; \
@@ -311,98 +265,39 @@ static sauMaybeUnused void sauRasG_map_v_urand(sauRasG *restrict o,
 		float a = sau_fscalei(s1 - s0, 0x1p-31f); \
 		float b = sau_fscalei(s2 - s1, 0x1p-31f); \
 /**/
-		RASG_MAP_v_urand
-		end_a_buf[i] = a;
-		end_b_buf[i] = b;
-	}
-}
-
-RASG_MAP_S_FUNC(v_urand)
-
-/**
- * Run for \p buf_len samples in 'uniform random' mode, generating output.
- */
-static sauMaybeUnused void sauRasG_map_urand(sauRasG *restrict o,
-		size_t buf_len,
-		float *restrict end_a_buf,
-		float *restrict end_b_buf,
-		const uint32_t *restrict cycle_buf) {
-	if (o->opt.flags & SAU_RAS_O_VIOLET) {
-		sauRasG_map_v_urand(o, buf_len, end_a_buf,end_b_buf, cycle_buf);
-		return;
-	}
-	for (size_t i = 0; i < buf_len; ++i) {
-		uint32_t cycle = cycle_buf[i];
-#define RASG_MAP_urand \
-		float a = sau_fscalei(sau_ranfast32(cycle), 0x1p-31f); \
-		float b = sau_fscalei(sau_ranfast32(cycle + 1), 0x1p-31f); \
-/**/
-		RASG_MAP_urand
-		end_a_buf[i] = a;
-		end_b_buf[i] = b;
-	}
-}
 
-/**
- * Run for \p buf_len samples in 'uniform random' mode, generating output.
- *
- * Self-modulation version, slower and more flexible design.
- */
-static sauMaybeUnused void sauRasG_map_urand_s(sauRasG *restrict o,
-		size_t buf_len,
-		float *restrict main_buf,
-		sauLine_val_f line_f,
-		const uint32_t *restrict cycle_buf,
-		const float *restrict pm_abuf) {
-	if (o->opt.flags & SAU_RAS_O_VIOLET) {
-		sauRasG_map_v_urand_s(o, buf_len, main_buf, line_f,
-				cycle_buf, pm_abuf);
-		return;
-	}
-	RASG_MAP_S_LOOP(urand)
-}
-
-/**
- * Run for \p buf_len samples in 'Gaussian random' mode, generating output.
+/*
+ * 'Gaussian random' mode.
  */
-static sauMaybeUnused void sauRasG_map_gauss(sauRasG *restrict o,
-		size_t buf_len,
-		float *restrict end_a_buf,
-		float *restrict end_b_buf,
-		const uint32_t *restrict cycle_buf) {
-	(void)o;
-	for (size_t i = 0; i < buf_len; ++i) {
-		uint32_t cycle = cycle_buf[i];
 #define RASG_MAP_gauss \
 		float a = sau_franssgauss32(cycle); \
 		float b = sau_franssgauss32(cycle + 1); \
 /**/
-		RASG_MAP_gauss
-		end_a_buf[i] = a;
-		end_b_buf[i] = b;
-	}
-}
 
-RASG_MAP_S_FUNC(gauss)
+/*
+ * 'Binary random' mode.
+ * For an increasing \a level > 0 each new level is half as squiggly, for
+ * a near-binary mode when above 5 (with best quality seemingly from 27).
+ */
+#define RASG_MAP_bin \
+		uint32_t offs = INT32_MAX + (cycle & 1) * 2; \
+		uint32_t s1 = sau_sar32(sau_ranfast32(cycle), sr) + offs; \
+		uint32_t s2 = sau_sar32(sau_ranfast32(cycle + 1), sr) - offs; \
+		float a = sau_fscalei(s1, 0x1p-31f); \
+		float b = sau_fscalei(s2, 0x1p-31f); \
+/**/
 
-/**
- * Run for \p buf_len samples in 'violet binary' mode -- a differentiated,
- * scaled 'ternary random' variation. Ternary smooth random always changes
- * value, so only two differences are possible -- hence diffed for binary.
+/*
+ * 'Violet binary' mode -- a differentiated, scaled 'ternary random'
+ * variation. Ternary smooth random always changes value -- so only
+ * two differences are possible -- hence diffed for binary.
+ *
+ * TODO: Scaling ends up slightly too low near sr == 1, improve?
  */
-static sauMaybeUnused void sauRasG_map_v_bin(sauRasG *restrict o,
-		size_t buf_len,
-		float *restrict end_a_buf,
-		float *restrict end_b_buf,
-		const uint32_t *restrict cycle_buf) {
-	int sr = o->opt.level;
-	// TODO: Scaling ends up slightly too low near sr == 1, improve?
-	const float scale_diff = 1.f
-		- (sau_sar32(INT32_MAX, sr) / 0x1p31f);
-	const float scale = (1.f + scale_diff*scale_diff) / 0x1p31f;
-	for (size_t i = 0; i < buf_len; ++i) {
-		uint32_t cycle = cycle_buf[i];
 #define RASG_MAP_v_bin \
+		const float scale_diff = 1.f \
+			- (sau_sar32(INT32_MAX, sr) / 0x1p31f); \
+		const float scale = (1.f + scale_diff*scale_diff) / 0x1p31f; \
 		uint32_t sb = (cycle & 1) << 31; \
 		uint32_t sb_flip = (1U<<31) - sb; \
 		uint32_t s0 = sau_divi(sau_sar32(sau_ranfast32(cycle - 1), sr) \
@@ -414,83 +309,9 @@ static sauMaybeUnused void sauRasG_map_v_bin(sauRasG *restrict o,
 		float a = sau_fscalei(s1 - s0, scale); \
 		float b = sau_fscalei(s2 - s1, scale); \
 /**/
-		RASG_MAP_v_bin
-		end_a_buf[i] = a;
-		end_b_buf[i] = b;
-	}
-}
 
-/**
- * Run for \p buf_len samples in 'violet binary' mode -- a differentiated,
- *
- * Self-modulation version, slower and more flexible design.
- */
-static sauMaybeUnused void sauRasG_map_v_bin_s(sauRasG *restrict o,
-		size_t buf_len,
-		float *restrict main_buf,
-		sauLine_val_f line_f,
-		const uint32_t *restrict cycle_buf,
-		const float *restrict pm_abuf) {
-	int sr = o->opt.level;
-	// TODO: Scaling ends up slightly too low near sr == 1, improve?
-	const float scale_diff = 1.f
-		- (sau_sar32(INT32_MAX, sr) / 0x1p31f);
-	const float scale = (1.f + scale_diff*scale_diff) / 0x1p31f;
-	RASG_MAP_S_LOOP(v_bin)
-}
-
-/**
- * Run for \p buf_len samples in 'binary random' mode, generating output.
- * For an increasing \a level > 0 each new level is half as squiggly, for
- * a near-binary mode when above 5 (with best quality seemingly from 27).
- */
-static sauMaybeUnused void sauRasG_map_bin(sauRasG *restrict o,
-		size_t buf_len,
-		float *restrict end_a_buf,
-		float *restrict end_b_buf,
-		const uint32_t *restrict cycle_buf) {
-	if (o->opt.flags & SAU_RAS_O_VIOLET) {
-		sauRasG_map_v_bin(o, buf_len, end_a_buf, end_b_buf, cycle_buf);
-		return;
-	}
-	int sr = o->opt.level;
-	for (size_t i = 0; i < buf_len; ++i) {
-		uint32_t cycle = cycle_buf[i];
-#define RASG_MAP_bin \
-		uint32_t offs = INT32_MAX + (cycle & 1) * 2; \
-		uint32_t s1 = sau_sar32(sau_ranfast32(cycle), sr) + offs; \
-		uint32_t s2 = sau_sar32(sau_ranfast32(cycle + 1), sr) - offs; \
-		float a = sau_fscalei(s1, 0x1p-31f); \
-		float b = sau_fscalei(s2, 0x1p-31f); \
-/**/
-		RASG_MAP_bin
-		end_a_buf[i] = a;
-		end_b_buf[i] = b;
-	}
-}
-
-/**
- * Run for \p buf_len samples in 'binary random' mode, generating output.
- *
- * Self-modulation version, slower and more flexible design.
- */
-static sauMaybeUnused void sauRasG_map_bin_s(sauRasG *restrict o,
-		size_t buf_len,
-		float *restrict main_buf,
-		sauLine_val_f line_f,
-		const uint32_t *restrict cycle_buf,
-		const float *restrict pm_abuf) {
-	if (o->opt.flags & SAU_RAS_O_VIOLET) {
-		sauRasG_map_v_bin_s(o, buf_len, main_buf, line_f,
-				cycle_buf, pm_abuf);
-		return;
-	}
-	int sr = o->opt.level;
-	RASG_MAP_S_LOOP(bin)
-}
-
-/**
- * Run for \p buf_len samples in 'ternary random' mode, generating output.
+/*
+ * 'Ternary random' mode.
  * For an increasing \a level > 0 each new level is half as squiggly, with
  * a practically ternary mode when above 5, but 30 is technically perfect.
  *
@@ -498,14 +319,6 @@ static sauMaybeUnused void sauRasG_map_bin_s(sauRasG *restrict o,
  * from top-or-bottom to middle, like an oscillation randomly flipping its
  * polarity at zero crossings. Smooth-sounding, and has useful properties.
  */
-static sauMaybeUnused void sauRasG_map_tern(sauRasG *restrict o,
-		size_t buf_len,
-		float *restrict end_a_buf,
-		float *restrict end_b_buf,
-		const uint32_t *restrict cycle_buf) {
-	int sr = o->opt.level;
-	for (size_t i = 0; i < buf_len; ++i) {
-		uint32_t cycle = cycle_buf[i];
 #define RASG_MAP_tern \
 		uint32_t sb = (cycle & 1) << 31; \
 		uint32_t sb_flip = (1U<<31) - sb; \
@@ -515,51 +328,27 @@ static sauMaybeUnused void sauRasG_map_tern(sauRasG *restrict o,
 		float a = sau_fscalei(s1, 0x1p-31f); \
 		float b = sau_fscalei(s2, 0x1p-31f); \
 /**/
-		RASG_MAP_tern
-		end_a_buf[i] = a;
-		end_b_buf[i] = b;
-	}
-}
-
-RASG_MAP_S_FUNC(tern)
 
-/**
- * Run for \p buf_len samples in 'fixed cycle' mode, generating output.
- * Simple version, optimizing high level (pure base frequency) setting.
+/*
+ * 'Fixed cycle' mode.
+ * For an increasing \a level > 0 each new level halves the randomness,
+ * the base frequency amplifying in its place (toward ultimate purity).
  */
-static sauMaybeUnused void sauRasG_map_fixed_simple(sauRasG *restrict o,
-		size_t buf_len,
-		float *restrict end_a_buf,
-		float *restrict end_b_buf,
-		const uint32_t *restrict cycle_buf) {
-	(void)o;
-	for (size_t i = 0; i < buf_len; ++i) {
-		uint32_t cycle = cycle_buf[i];
-#define RASG_MAP_fixed_simple \
-		float a = sau_oddness_as_sign(cycle); \
-		float b = -a; \
+#define RASG_MAP_fixed \
+		uint32_t sign = sau_oddness_as_sign(cycle); \
+		float a = sau_fscalei(-sign * \
+				((sau_ranfast32(cycle) >> sr) - \
+				 INT32_MAX), 0x1p-31f); \
+		float b = sau_fscalei(sign * \
+				((sau_ranfast32(cycle + 1) >> sr) - \
+				 INT32_MAX), 0x1p-31f); \
 /**/
-		RASG_MAP_fixed_simple
-		end_a_buf[i] = a;
-		end_b_buf[i] = b;
-	}
-}
 
-RASG_MAP_S_FUNC(fixed_simple)
-
-/**
- * Run for \p buf_len samples in 'violet fixed' (violet-fixed mix) mode.
+/*
+ * 'Violet fixed' (violet-fixed mix) mode.
  * For an increasing \a level > 0, each new level halves the randomness,
  * the base frequency amplifying in its place -- toward ultimate purity.
  */
-static sauMaybeUnused void sauRasG_map_v_fixed(sauRasG *restrict o,
-		size_t buf_len,
-		float *restrict end_a_buf,
-		float *restrict end_b_buf,
-		const uint32_t *restrict cycle_buf) {
-	int sr = o->opt.level;
-	for (size_t i = 0; i < buf_len; ++i) {
-		uint32_t cycle = cycle_buf[i];
 #define RASG_MAP_v_fixed \
 		uint32_t sign = sau_oddness_as_sign(cycle); \
 		uint32_t s0 = sau_divi(sign * \
@@ -574,114 +363,207 @@ static sauMaybeUnused void sauRasG_map_v_fixed(sauRasG *restrict o,
 		float a = sau_fscalei(s1 - s0, 0x1p-31f); \
 		float b = sau_fscalei(s2 - s1, 0x1p-31f); \
 /**/
-		RASG_MAP_v_fixed
-		end_a_buf[i] = a;
-		end_b_buf[i] = b;
+
+/*
+ * 'Fixed cycle' mode.
+ * Simple version, optimizing high level (pure base frequency) setting.
+ */
+#define RASG_MAP_fixed_simple \
+		float a = sau_oddness_as_sign(cycle); \
+		float b = -a; \
+/**/
+
+/*
+ * 'Additive recurrence' mode.
+ */
+#define RASG_MAP_addrec \
+		uint32_t s0 = cycle * o->opt.alpha; \
+		uint32_t s1 = (cycle+1) * o->opt.alpha; \
+		float a = sau_fscalei(s0, 0x1p-31f); \
+		float b = sau_fscalei(s1, 0x1p-31f); \
+/**/
+
+/*
+ * Get the random function variant to use, for sauRasG_run_funcs[]
+ * and sauRasG_run_selfmod_funcs[].
+ */
+static inline unsigned sauRasG_get_map_id(const sauRasG *restrict o) {
+	bool violet = o->opt.flags & SAU_RAS_O_VIOLET;
+	switch (o->opt.func) {
+	default:
+	case SAU_RAS_F_URAND:
+		return violet ? RASG_MAP_N_v_urand : RASG_MAP_N_urand;
+	case SAU_RAS_F_GAUSS:
+		return RASG_MAP_N_gauss;
+	case SAU_RAS_F_BIN:
+		return violet ? RASG_MAP_N_v_bin : RASG_MAP_N_bin;
+	case SAU_RAS_F_TERN:
+		return RASG_MAP_N_tern;
+	case SAU_RAS_F_FIXED:
+		if (o->opt.level >= sau_ras_level(9))
+			return RASG_MAP_N_fixed_simple;
+		return violet ? RASG_MAP_N_v_fixed : RASG_MAP_N_fixed;
+	case SAU_RAS_F_ADDREC:
+		return RASG_MAP_N_addrec;
 	}
 }
 
-RASG_MAP_S_FUNC(v_fixed)
-
-/**
- * Run for \p buf_len samples in 'fixed cycle' mode, generating output.
- * For an increasing \a level > 0 each new level halves the randomness,
- * the base frequency amplifying in its place (toward ultimate purity).
+/*
+ * Apply the modifying flags other than Perlin to line segment end values.
  */
-static sauMaybeUnused void sauRasG_map_fixed(sauRasG *restrict o,
-		size_t buf_len,
-		float *restrict end_a_buf,
-		float *restrict end_b_buf,
-		const uint32_t *restrict cycle_buf) {
-	if (o->opt.level >= sau_ras_level(9)) {
-		sauRasG_map_fixed_simple(o, buf_len, end_a_buf, end_b_buf,
-				cycle_buf);
-		return;
+static inline void sauRasG_shape_ends(unsigned flags,
+		float *restrict a, float *restrict b) {
+	if (flags & SAU_RAS_O_HALFSHAPE) {
+		/* sort value-pairs, for a decreasing sawtooth-like waveform */
+		float max = sau_maxf(*a, *b);
+		float min = sau_minf(*a, *b);
+		*a = max;
+		*b = min;
 	}
-	if (o->opt.flags & SAU_RAS_O_VIOLET) {
-		sauRasG_map_v_fixed(o, buf_len, end_a_buf, end_b_buf,
-				cycle_buf);
-		return;
+	if (flags & SAU_RAS_O_ZIGZAG) {
+		/* swap half-cycle ends for jagged shape on random amplitude */
+		float tmp = *a; *a = *b; *b = tmp;
 	}
-	int sr = o->opt.level;
-	for (size_t i = 0; i < buf_len; ++i) {
-		uint32_t cycle = cycle_buf[i];
-#define RASG_MAP_fixed \
-		uint32_t sign = sau_oddness_as_sign(cycle); \
-		float a = sau_fscalei(-sign * \
-				((sau_ranfast32(cycle) >> sr) - \
-				 INT32_MAX), 0x1p-31f); \
-		float b = sau_fscalei(sign * \
-				((sau_ranfast32(cycle + 1) >> sr) - \
-				 INT32_MAX), 0x1p-31f); \
-/**/
-		RASG_MAP_fixed
-		end_a_buf[i] = a;
-		end_b_buf[i] = b;
+	if (flags & SAU_RAS_O_SQUARE) {
+		/* square keeping sign; value uniformity to energy uniformity */
+		*a *= fabsf(*a);
+		*b *= fabsf(*b);
 	}
 }
 
-/**
- * Run for \p buf_len samples in 'fixed cycle' mode, generating output.
- *
- * Self-modulation version, slower and more flexible design.
+/*
+ * Get amplitude scaling for Perlin mode, for a line type \p line.
  */
-static sauMaybeUnused void sauRasG_map_fixed_s(sauRasG *restrict o,
+static inline float sauRasG_perlin_amp(unsigned flags, unsigned line) {
+	return (flags & (SAU_RAS_O_HALFSHAPE|SAU_RAS_O_ZIGZAG)) ?
+		1.f :
+		sauLine_coeffs[line].perlin_amp;
+}
+
+typedef void (*sauRasG_run_f)(sauRasG *restrict o,
+		size_t buf_len,
+		float *restrict main_buf,
+		const uint32_t *restrict cycle_buf);
+
+typedef void (*sauRasG_run_selfmod_f)(sauRasG *restrict o,
 		size_t buf_len,
 		float *restrict main_buf,
-		sauLine_val_f line_f,
 		const uint32_t *restrict cycle_buf,
-		const float *restrict pm_abuf) {
-	if (o->opt.level >= sau_ras_level(9)) {
-		sauRasG_map_fixed_simple_s(o, buf_len, main_buf, line_f,
-				cycle_buf, pm_abuf);
-		return;
-	}
-	if (o->opt.flags & SAU_RAS_O_VIOLET) {
-		sauRasG_map_v_fixed_s(o, buf_len, main_buf, line_f,
-				cycle_buf, pm_abuf);
-		return;
-	}
-	int sr = o->opt.level;
-	RASG_MAP_S_LOOP(fixed)
-}
+		const float *restrict pm_abuf);
 
-/**
- * Run for \p buf_len samples in 'additive recurrence' mode, generating output.
+/*
+ * Define a sauRasG_perlin_*() function for line type \p LINE, used for
+ * a run of samples in one cycle in Perlin mode, where the end values
+ * are scaled by phase. Shared by the sauRasG_run_*() functions.
  */
-static sauMaybeUnused void sauRasG_map_addrec(sauRasG *restrict o,
-		size_t buf_len,
-		float *restrict end_a_buf,
-		float *restrict end_b_buf,
-		const uint32_t *restrict cycle_buf) {
-	(void)o;
-	for (size_t i = 0; i < buf_len; ++i) {
-		uint32_t cycle = cycle_buf[i];
-#define RASG_MAP_addrec \
-		uint32_t s0 = cycle * o->opt.alpha; \
-		uint32_t s1 = (cycle+1) * o->opt.alpha; \
-		float a = sau_fscalei(s0, 0x1p-31f); \
-		float b = sau_fscalei(s1, 0x1p-31f); \
-/**/
-		RASG_MAP_addrec
-		end_a_buf[i] = a;
-		end_b_buf[i] = b;
-	}
+#define RASG_PERLIN_FUNC(LINE, ...) \
+static sauMaybeUnused sauNoinline void sauRasG_perlin_##LINE( \
+		float *restrict buf, size_t len, \
+		float a, float b, unsigned flags) { \
+	const float perlin_amp = \
+		sauRasG_perlin_amp(flags, SAU_LINE_N_##LINE); \
+	for (size_t i = 0; i < len; ++i) { \
+		float phase = buf[i]; \
+		float p_a = a * (perlin_amp*phase); \
+		float p_b = b * (perlin_amp*(phase-1.f)); \
+		sauRasG_shape_ends(flags, &p_a, &p_b); \
+		buf[i] = sauLine_val_##LINE(phase, p_a, p_b); \
+	} \
 }
 
-RASG_MAP_S_FUNC(addrec)
+SAU_LINE__ITEMS(RASG_PERLIN_FUNC)
 
-static inline sauRasG_map_f sauRasG_get_map_f(unsigned func) {
-	switch (func) {
-	default:
-	case SAU_RAS_F_URAND: return sauRasG_map_urand;
-	case SAU_RAS_F_GAUSS: return sauRasG_map_gauss;
-	case SAU_RAS_F_BIN: return sauRasG_map_bin;
-	case SAU_RAS_F_TERN: return sauRasG_map_tern;
-	case SAU_RAS_F_FIXED: return sauRasG_map_fixed;
-	case SAU_RAS_F_ADDREC: return sauRasG_map_addrec;
-	}
+/*
+ * Define a whole sauRasG_run_*() function, for a random function
+ * variant \p MAP and line type \p LINE, mapping phase to output in
+ * a single pass. The segment end values only change with the cycle,
+ * so they are calculated once for each run of samples in a cycle,
+ * which is then mapped by the line's segment function.
+ */
+#define RASG_RUN_FUNC(MAP, LINE) \
+static sauMaybeUnused void sauRasG_run_##MAP##_##LINE(sauRasG *restrict o, \
+		size_t buf_len, \
+		float *restrict main_buf, \
+		const uint32_t *restrict cycle_buf) { \
+	int sauMaybeUnused sr = o->opt.level; \
+	const unsigned flags = o->opt.flags; \
+	for (size_t i = 0, j; i < buf_len; i = j) { \
+		uint32_t cycle = cycle_buf[i]; \
+		/**/ RASG_MAP_##MAP \
+		for (j = i + 1; j < buf_len && cycle_buf[j] == cycle; ++j) \
+			; \
+		if (flags & SAU_RAS_O_PERLIN) { \
+			sauRasG_perlin_##LINE(main_buf + i, j - i, \
+					a, b, flags); \
+			continue; \
+		} \
+		sauRasG_shape_ends(flags, &a, &b); \
+		sauLine_seg_##LINE(main_buf + i, j - i, a, b); \
+	} \
+}
+
+/*
+ * Define a whole sauRasG_run_*_s() function, for a random function
+ * variant \p MAP and line type \p LINE, with self-modulation.
+ */
+#define RASG_RUN_S_FUNC(MAP, LINE) \
+static sauMaybeUnused void sauRasG_run_##MAP##_##LINE##_s(sauRasG *restrict o,\
+		size_t buf_len, \
+		float *restrict main_buf, \
+		const uint32_t *restrict cycle_buf, \
+		const float *restrict pm_abuf) { \
+	int sauMaybeUnused sr = o->opt.level; \
+	const unsigned flags = o->opt.flags; \
+	const float perlin_amp = \
+		sauRasG_perlin_amp(flags, SAU_LINE_N_##LINE); \
+	for (size_t i = 0; i < buf_len; ++i) { \
+		float pm_a = o->fb_s * pm_abuf[i] * 0.5f; \
+		float phase = main_buf[i] + pm_a; \
+		int32_t cycle_adj = floorf(phase); \
+		uint32_t cycle = cycle_buf[i] + cycle_adj; \
+		phase -= cycle_adj; \
+		/**/ RASG_MAP_##MAP \
+		if (flags & SAU_RAS_O_PERLIN) { \
+			a *= perlin_amp*phase; \
+			b *= perlin_amp*(phase-1.f); \
+		} \
+		sauRasG_shape_ends(flags, &a, &b); \
+		float s = sauLine_val_##LINE(phase, a, b); \
+		main_buf[i] = s; \
+		/* Suppress ringing using 1-pole filter + 1-zero filter. */ \
+		o->fb_s = (o->fb_s + s + o->prev_s) * 0.5f; \
+		o->prev_s = s; \
+	} \
 }
 
+#define RASG__X_RUN_FUNCS(MAP, LINE) \
+	RASG_RUN_FUNC(MAP, LINE) \
+	RASG_RUN_S_FUNC(MAP, LINE)
+#define RASG__X_LINE_RUN_FUNCS(LINE, ...) \
+	RASG__MAP_ITEMS(RASG__X_RUN_FUNCS, LINE)
+
+// generate for all pairs of random function variant and line type
+SAU_LINE__ITEMS(RASG__X_LINE_RUN_FUNCS)
+
+#define RASG__X_RUN_ADDR(MAP, LINE) sauRasG_run_##MAP##_##LINE,
+#define RASG__X_RUN_S_ADDR(MAP, LINE) sauRasG_run_##MAP##_##LINE##_s,
+#define RASG__X_LINE_RUN_ADDRS(LINE, ...) \
+	{RASG__MAP_ITEMS(RASG__X_RUN_ADDR, LINE)},
+#define RASG__X_LINE_RUN_S_ADDRS(LINE, ...) \
+	{RASG__MAP_ITEMS(RASG__X_RUN_S_ADDR, LINE)},
+
+/* Run functions by line type and random function variant. */
+static const sauRasG_run_f
+sauRasG_run_funcs[SAU_LINE_NAMED][RASG_MAP_NAMED] = {
+	SAU_LINE__ITEMS(RASG__X_LINE_RUN_ADDRS)
+};
+
+/* Self-modulation run functions by line type and random function variant. */
+static const sauRasG_run_selfmod_f
+sauRasG_run_selfmod_funcs[SAU_LINE_NAMED][RASG_MAP_NAMED] = {
+	SAU_LINE__ITEMS(RASG__X_LINE_RUN_S_ADDRS)
+};
+
 /**
  * Run for \p buf_len samples, generating output.
  * Expects phase values to be held inside \p main_buf;
@@ -692,46 +574,10 @@ static inline sauRasG_map_f sauRasG_get_map_f(unsigned func) {
 static sauMaybeUnused void sauRasG_run(sauRasG *restrict o,
 		size_t buf_len,
 		float *restrict main_buf,
-		float *restrict end_a_buf,
-		float *restrict end_b_buf,
 		const uint32_t *restrict cycle_buf) {
-	sauRasG_map_f map = sauRasG_get_map_f(o->opt.func);
-	map(o, buf_len, end_a_buf, end_b_buf, cycle_buf);
-	const unsigned flags = o->opt.flags, line = o->opt.line;
-	if (flags & SAU_RAS_O_PERLIN) {
-		const float perlin_amp =
-			(flags & (SAU_RAS_O_HALFSHAPE|SAU_RAS_O_ZIGZAG)) ?
-			1.f :
-			sauLine_coeffs[line].perlin_amp;
-		for (size_t i = 0; i < buf_len; ++i) {
-			float phase = main_buf[i];
-			end_a_buf[i] *= perlin_amp*phase;
-			end_b_buf[i] *= perlin_amp*(phase-1.f);
-		}
-	}
-	if (flags & SAU_RAS_O_HALFSHAPE) {
-		/* sort value-pairs, for a decreasing sawtooth-like waveform */
-		for (size_t i = 0; i < buf_len; ++i) {
-			float a = end_a_buf[i];
-			float b = end_b_buf[i];
-			end_a_buf[i] = sau_maxf(a, b);
-			end_b_buf[i] = sau_minf(a, b);
-		}
-	}
-	if (flags & SAU_RAS_O_ZIGZAG) {
-		/* swap half-cycle ends for jagged shape on random amplitude */
-		float *tmp_buf = end_a_buf;
-		end_a_buf = end_b_buf; end_b_buf = tmp_buf;
-	}
-	if (flags & SAU_RAS_O_SQUARE) {
-		/* square keeping sign; value uniformity to energy uniformity */
-		for (size_t i = 0; i < buf_len; ++i) {
-			end_a_buf[i] *= fabsf(end_a_buf[i]);
-			end_b_buf[i] *= fabsf(end_b_buf[i]);
-		}
-	}
-	sauLine_map_funcs[line](main_buf, buf_len,
-			end_a_buf, end_b_buf);
+	sauRasG_run_f run =
+		sauRasG_run_funcs[o->opt.line][sauRasG_get_map_id(o)];
+	run(o, buf_len, main_buf, cycle_buf);
 #if RASG_MEASURE_LINE_AMP /* measure output, needed for Perlin mode coeff */
 	static float min, max;
 	for (size_t i = 0; i < buf_len; ++i) {
@@ -742,18 +588,6 @@ static sauMaybeUnused void sauRasG_run(sauRasG *restrict o,
 #endif
 }
 
-static inline sauRasG_map_selfmod_f sauRasG_get_map_selfmod_f(unsigned func) {
-	switch (func) {
-	default:
-	case SAU_RAS_F_URAND: return sauRasG_map_urand_s;
-	case SAU_RAS_F_GAUSS: return sauRasG_map_gauss_s;
-	case SAU_RAS_F_BIN: return sauRasG_map_bin_s;
-	case SAU_RAS_F_TERN: return sauRasG_map_tern_s;
-	case SAU_RAS_F_FIXED: return sauRasG_map_fixed_s;
-	case SAU_RAS_F_ADDREC: return sauRasG_map_addrec_s;
-	}
-}
-
 /**
  * Run for \p buf_len samples, generating output, with self-modulation.
  * Expects phase values to be held inside \p main_buf;
@@ -766,7 +600,7 @@ static sauMaybeUnused void sauRasG_run_selfmod(sauRasG *restrict o,
 		float *restrict main_buf,
 		const uint32_t *restrict cycle_buf,
 		const float *restrict pm_abuf) {
-	sauRasG_map_selfmod_f map = sauRasG_get_map_selfmod_f(o->opt.func);
-	sauLine_val_f line_f = sauLine_val_funcs[o->opt.line];
-	map(o, buf_len, main_buf, line_f, cycle_buf, pm_abuf);
+	sauRasG_run_selfmod_f run =
+		sauRasG_run_selfmod_funcs[o->opt.line][sauRasG_get_map_id(o)];
+	run(o, buf_len, main_buf, cycle_buf, pm_abuf);
 }
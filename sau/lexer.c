@@ -90,7 +90,7 @@ void sau_destroy_Lexer(sauLexer *restrict o) {
  */
 bool sauLexer_open(sauLexer *restrict o,
 		const char *restrict script, bool is_path) {
-	return sauScanner_open(o->sc, script, is_path);
+	return sauScanner_open(o->sc, script, is_path, NULL);
 }
 
 /**
@@ -13,8 +13,21 @@
 
 #include <sau/line.h>
 
+/*
+ * Loop for a fill function, with the value expression \p V (using \a i)
+ * placed in one of two variants, chosen outside of the loop depending on
+ * whether \a mulbuf is used. Straight loops are vectorized more easily.
+ */
+#define LINE_FILL_LOOP(V) do { \
+	if (mulbuf != NULL) { \
+		for (uint32_t i = 0; i < len; ++i) buf[i] = (V) * mulbuf[i]; \
+	} else { \
+		for (uint32_t i = 0; i < len; ++i) buf[i] = (V); \
+	} \
+} while (0)
+
 #define LINE_MAP_FUNC(NAME, ...) \
-void sauLine_map_##NAME(float *restrict buf, uint32_t len, \
+sauSIMDclones void sauLine_map_##NAME(float *restrict buf, uint32_t len, \
 		const float *restrict end0, const float *restrict end1) { \
 	for (uint32_t i = 0; i < len; ++i) \
 		buf[i] = sauLine_val_##NAME(buf[i], end0[i], end1[i]); \
@@ -23,17 +36,23 @@ void sauLine_map_##NAME(float *restrict buf, uint32_t len, \
 // all of them have the same form, so just generate them all
 SAU_LINE__ITEMS(LINE_MAP_FUNC)
 
+#define LINE_SEG_FUNC(NAME, ...) \
+sauSIMDclones void sauLine_seg_##NAME(float *restrict buf, uint32_t len, \
+		float a, float b) { \
+	for (uint32_t i = 0; i < len; ++i) \
+		buf[i] = sauLine_val_##NAME(buf[i], a, b); \
+}
+
+SAU_LINE__ITEMS(LINE_SEG_FUNC)
+
 // fill functions not written in a different optimized form
 #define LINE_FILL_FUNC(NAME, ...) \
-void sauLine_fill_##NAME(float *restrict buf, uint32_t len, \
+sauSIMDclones void sauLine_fill_##NAME(float *restrict buf, uint32_t len, \
 		float v0, float vt, uint32_t pos, uint32_t time, \
 		const float *restrict mulbuf) { \
 	const float inv_time = 1.f / time; \
-	for (uint32_t i = 0; i < len; ++i) { \
-		float x = (i + pos) * inv_time; \
-		float v = sauLine_val_##NAME(x, v0, vt); \
-		buf[i] = mulbuf ? (v * mulbuf[i]) : v; \
-	} \
+	LINE_FILL_LOOP(sauLine_val_##NAME( \
+		(i + pos) * inv_time, v0, vt)); \
 }
 
 const struct sauLineCoeffs sauLine_coeffs[SAU_LINE_NAMED] = {
@@ -57,19 +76,41 @@ const sauLine_val_f sauLine_val_funcs[SAU_LINE_NAMED] = {
 	SAU_LINE__ITEMS(SAU_LINE__X_VAL_ADDR)
 };
 
+/* Square of \p x, for 'sqe' fill. */
+static inline float sqe_x2(float x) {
+	return x * x;
+}
+
+/* Cube-based curve value for \p x, for 'cub' fill. */
+static inline float cub_x3(float x) {
+	return x * x * x * 0.5f + 0.5f;
+}
+
+/* Centered 'ncl' position for \p x with noise \p s times \p scale added. */
+static inline float ncl_x(float x, int32_t s, float scale) {
+	float xb = x + 0.5f; xb -= (3.f - (xb+xb))*xb*xb;
+	return x + xb * s * scale;
+}
+
+/* Centered 'nhl' position for \p x with noise \p s times \p scale added. */
+static inline float nhl_x(float x, int32_t s, float scale) {
+	float xb = x + 0.5f; xb -= xb*xb;
+	return x + xb * s * scale;
+}
+
 // the noinline use below works around i386 clang performance issue
 /**
  * Fill \p buf with \p len values along a "sample and hold"
  * straight horizontal line, i.e. \p len copies of \p v0.
  */
-sauNoinline void sauLine_fill_sah(float *restrict buf, uint32_t len,
+sauNoinline sauSIMDclones
+void sauLine_fill_sah(float *restrict buf, uint32_t len,
 		float v0, float vt, uint32_t pos, uint32_t time,
 		const float *restrict mulbuf) {
 	(void)vt;
 	(void)pos;
 	(void)time;
-	for (uint32_t i = 0; i < len; ++i)
-		buf[i] = mulbuf ? (v0 * mulbuf[i]) : v0;
+	LINE_FILL_LOOP(v0);
 }
 
 /**
@@ -77,18 +118,14 @@ sauNoinline void sauLine_fill_sah(float *restrict buf, uint32_t len,
  * from \p v0 (at position 0) to \p vt (at position \p time),
  * beginning at position \p pos.
  */
-void sauLine_fill_lin(float *restrict buf, uint32_t len,
+sauSIMDclones void sauLine_fill_lin(float *restrict buf, uint32_t len,
 		float v0, float vt, uint32_t pos, uint32_t time,
 		const float *restrict mulbuf) {
 	const int32_t adj_pos = pos - (time / 2);
 	const float inv_time = 1.f / time;
 	const float vm = (v0 + vt) * 0.5f;
 	const float vd = (vt - v0);
-	for (uint32_t i = 0; i < len; ++i) {
-		float x = ((int32_t)i + adj_pos) * inv_time;
-		float v = vm + vd * x;
-		buf[i] = mulbuf ? (v * mulbuf[i]) : v;
-	}
+	LINE_FILL_LOOP(vm + vd * (((int32_t)i + adj_pos) * inv_time));
 }
 
 /**
@@ -99,18 +136,15 @@ void sauLine_fill_lin(float *restrict buf, uint32_t len,
  * Rises or falls similarly to how sin() moves from trough to
  * crest and back. Uses a ~99.993% accurate polynomial curve.
  */
-void sauLine_fill_cos(float *restrict buf, uint32_t len,
+sauSIMDclones void sauLine_fill_cos(float *restrict buf, uint32_t len,
 		float v0, float vt, uint32_t pos, uint32_t time,
 		const float *restrict mulbuf) {
 	const int32_t adj_pos = pos - (time / 2);
 	const float inv_time = 1.f / time;
 	const float vm = (v0 + vt) * 0.5f;
 	const float vd = (vt - v0);
-	for (uint32_t i = 0; i < len; ++i) {
-		float x = ((int32_t)i + adj_pos) * inv_time;
-		float v = vm + vd * sau_sinramp(x);
-		buf[i] = mulbuf ? (v * mulbuf[i]) : v;
-	}
+	LINE_FILL_LOOP(vm + vd *
+		sau_sinramp(((int32_t)i + adj_pos) * inv_time));
 }
 
 /**
@@ -178,16 +212,13 @@ LINE_FILL_FUNC(lge, )
  * Uses half a parabola shape for a monotonic trajectory.
  * A less-steep alternative to the exponential-ish 'xpe' fill type.
  */
-void sauLine_fill_sqe(float *restrict buf, uint32_t len,
+sauSIMDclones void sauLine_fill_sqe(float *restrict buf, uint32_t len,
 		float v0, float vt, uint32_t pos, uint32_t time,
 		const float *restrict mulbuf) {
 	const int32_t adj_pos = pos - (time / 2);
 	const float inv_time = 1.f / time;
-	for (uint32_t i = 0; i < len; ++i) {
-		float x = 0.5f - ((int32_t)i + adj_pos) * inv_time;
-		float v = vt + (v0 - vt) * (x * x);
-		buf[i] = mulbuf ? (v * mulbuf[i]) : v;
-	}
+	LINE_FILL_LOOP(vt + (v0 - vt) *
+		sqe_x2(0.5f - ((int32_t)i + adj_pos) * inv_time));
 }
 
 /**
@@ -198,17 +229,14 @@ void sauLine_fill_sqe(float *restrict buf, uint32_t len,
  * Uses both lower and upper parts (from -1 to +1) of a cube line.
  * A little bit like three stages in one (change, sustain, change).
  */
-void sauLine_fill_cub(float *restrict buf, uint32_t len,
+sauSIMDclones void sauLine_fill_cub(float *restrict buf, uint32_t len,
 		float v0, float vt, uint32_t pos, uint32_t time,
 		const float *restrict mulbuf) {
 	const int32_t adj_pos = pos - (time / 2);
 	const float inv_time = 1.f / time;
 	const float scale = -2 * inv_time;
-	for (uint32_t i = 0; i < len; ++i) {
-		float x = ((int32_t)i + adj_pos) * scale;
-		float v = vt + (v0 - vt) * (x * x * x * 0.5f + 0.5f);
-		buf[i] = mulbuf ? (v * mulbuf[i]) : v;
-	}
+	LINE_FILL_LOOP(vt + (v0 - vt) *
+		cub_x3(((int32_t)i + adj_pos) * scale));
 }
 
 /**
@@ -222,18 +250,14 @@ LINE_FILL_FUNC(smo, )
  * Fill \p buf with \p len values of uniform white noise
  * between \p v0 and \p vt, seeded with position \p pos.
  */
-void sauLine_fill_uwh(float *restrict buf, uint32_t len,
+sauSIMDclones void sauLine_fill_uwh(float *restrict buf, uint32_t len,
 		float v0, float vt, uint32_t pos, uint32_t time,
 		const float *restrict mulbuf) {
 	const float scale = 0.5f/(float)INT32_MAX;
 	const float vm = (v0 + vt) * 0.5f;
 	const float vd = (vt - v0) * scale;
 	(void)time;
-	for (uint32_t i = 0; i < len; ++i) {
-		int32_t s = sau_ranfast32(pos + i);
-		float v = vm + vd * s;
-		buf[i] = mulbuf ? (v * mulbuf[i]) : v;
-	}
+	LINE_FILL_LOOP(vm + vd * (int32_t) sau_ranfast32(pos + i));
 }
 
 /**
@@ -241,7 +265,7 @@ void sauLine_fill_uwh(float *restrict buf, uint32_t len,
  * plus two softer white noise bulges), between \p v0 and \p vt,
  * seeded with position \p pos.
  */
-void sauLine_fill_ncl(float *restrict buf, uint32_t len,
+sauSIMDclones void sauLine_fill_ncl(float *restrict buf, uint32_t len,
 		float v0, float vt, uint32_t pos, uint32_t time,
 		const float *restrict mulbuf) {
 	const int32_t adj_pos = pos - (time / 2);
@@ -249,13 +273,8 @@ void sauLine_fill_ncl(float *restrict buf, uint32_t len,
 	const float scale = 0.5f/(float)INT32_MAX;
 	const float vm = (v0 + vt) * 0.5f;
 	const float vd = (vt - v0);
-	for (uint32_t i = 0; i < len; ++i) {
-		float x = ((int32_t)i + adj_pos) * inv_time;
-		float xb = x + 0.5f; xb -= (3.f - (xb+xb))*xb*xb;
-		int32_t s = sau_ranfast32(pos + i);
-		float v = vm + vd * (x + xb * s * scale);
-		buf[i] = mulbuf ? (v * mulbuf[i]) : v;
-	}
+	LINE_FILL_LOOP(vm + vd * ncl_x(((int32_t)i + adj_pos) * inv_time,
+				sau_ranfast32(pos + i), scale));
 }
 
 /**
@@ -263,7 +282,7 @@ void sauLine_fill_ncl(float *restrict buf, uint32_t len,
  * plus broad, big white noise bulge), between \p v0 and \p vt,
  * seeded with position \p pos.
  */
-void sauLine_fill_nhl(float *restrict buf, uint32_t len,
+sauSIMDclones void sauLine_fill_nhl(float *restrict buf, uint32_t len,
 		float v0, float vt, uint32_t pos, uint32_t time,
 		const float *restrict mulbuf) {
 	const int32_t adj_pos = pos - (time / 2);
@@ -271,13 +290,8 @@ void sauLine_fill_nhl(float *restrict buf, uint32_t len,
 	const float scale = 2 * 0.5f/(float)INT32_MAX;
 	const float vm = (v0 + vt) * 0.5f;
 	const float vd = (vt - v0);
-	for (uint32_t i = 0; i < len; ++i) {
-		float x = ((int32_t)i + adj_pos) * inv_time;
-		float xb = x + 0.5f; xb -= xb*xb;
-		int32_t s = sau_ranfast32(pos + i);
-		float v = vm + vd * (x + xb * s * scale);
-		buf[i] = mulbuf ? (v * mulbuf[i]) : v;
-	}
+	LINE_FILL_LOOP(vm + vd * nhl_x(((int32_t)i + adj_pos) * inv_time,
+				sau_ranfast32(pos + i), scale));
 }
 
 /**
@@ -309,6 +323,9 @@ void sauLine_copy(sauLine *restrict o,
 		if (src->flags & SAU_LINEP_TIME_IF_NEW)
 			o->end -= o->pos;
 		o->pos = 0;
+		o->segs = src->segs;
+		o->seg_count = src->seg_count;
+		o->seg = 0;
 		mask |= SAU_LINEP_GOAL
 			| SAU_LINEP_GOAL_RATIO;
 	}
@@ -329,6 +346,7 @@ void sauLine_copy(sauLine *restrict o,
 	}
 	o->flags &= ~mask;
 	o->flags |= (src->flags & mask);
+	o->srate = srate;
 }
 
 /**
@@ -397,6 +415,25 @@ static bool advance_len(sauLine *restrict o, uint32_t buf_len) {
 	return true;
 }
 
+/*
+ * Begin the next segment, if any, once the current goal is reached.
+ * The goal becomes the new state value, and the segment the new goal.
+ *
+ * \return true if a further segment was begun
+ */
+static bool next_seg(sauLine *restrict o) {
+	if (o->seg >= o->seg_count)
+		return false;
+	const sauLineSeg *seg = &o->segs[o->seg++];
+	o->v0 = o->vt;
+	o->vt = seg->vt;
+	o->type = seg->type;
+	o->pos = 0;
+	o->end = sau_ms_in_samples(seg->time_ms, o->srate, NULL);
+	o->time_ms = seg->time_ms;
+	return true;
+}
+
 /**
  * Fill \p buf with \p buf_len values for the line.
  * A value is \a v0 if no goal is set, or a lineing
@@ -409,8 +446,9 @@ static bool advance_len(sauLine *restrict o, uint32_t buf_len) {
  * with the same result as if given 1.0 values.)
  * Otherwise \p mulbuf is ignored.
  *
- * When a goal is reached and cleared, its \a vt value becomes
- * the new \a v0 value.
+ * When a goal is reached, any further segment is begun, and
+ * filling continues with it. When the last goal is reached
+ * and cleared, its \a vt value becomes the new \a v0 value.
  *
  * \return true if line goal not yet reached
  */
@@ -422,52 +460,71 @@ bool sauLine_run(sauLine *restrict o,
 		advance_len(o, buf_len);
 		goto FILL;
 	}
-	len = sauLine_get(o, buf, buf_len, mulbuf);
-	o->pos += len;
-	if (o->pos >= o->end) {
-		/*
-		 * Goal reached; turn into new state value,
-		 * filling remaining buffer values with it.
-		 */
-		o->v0 = o->vt;
-		o->pos = 0;
-		o->flags&=~(SAU_LINEP_GOAL|SAU_LINEP_GOAL_RATIO|SAU_LINEP_TIME);
-	FILL:
-		if (!(o->flags & SAU_LINEP_STATE_RATIO))
-			mulbuf = NULL;
-		else if (mulbuf != NULL)
-			mulbuf += len;
-		sauLine_fill_sah(buf + len, buf_len - len,
-				o->v0, o->v0, 0, 0, mulbuf);
-		return false;
+	for (;;) {
+		uint32_t seg_len = sauLine_get(o, buf + len, buf_len - len,
+				mulbuf ? mulbuf + len : NULL);
+		len += seg_len;
+		o->pos += seg_len;
+		if (o->pos < o->end)
+			return true;
+		if (!next_seg(o))
+			break;
 	}
-	return true;
+	/*
+	 * Goal reached; turn into new state value,
+	 * filling remaining buffer values with it.
+	 */
+	o->v0 = o->vt;
+	o->pos = 0;
+	o->flags &= ~(SAU_LINEP_GOAL|SAU_LINEP_GOAL_RATIO|SAU_LINEP_TIME);
+FILL:
+	if (!(o->flags & SAU_LINEP_STATE_RATIO))
+		mulbuf = NULL;
+	else if (mulbuf != NULL)
+		mulbuf += len;
+	sauLine_fill_sah(buf + len, buf_len - len,
+			o->v0, o->v0, 0, 0, mulbuf);
+	return false;
 }
 
 /**
  * Skip ahead \p skip_len values for the line, updating state
  * and run position without generating values.
  *
- * When a goal is reached and cleared, its \a vt value becomes
- * the new \a v0 value.
+ * When a goal is reached, any further segment is begun, and
+ * skipping continues with it. When the last goal is reached
+ * and cleared, its \a vt value becomes the new \a v0 value.
  *
  * \return true if line goal not yet reached
  */
 bool sauLine_skip(sauLine *restrict o, uint32_t skip_len) {
-	if (!advance_len(o, skip_len)) {
-		if (!(o->flags & SAU_LINEP_GOAL))
-			return false;
-		/*
-		 * Goal reached; turn into new state value.
-		 */
-		o->v0 = o->vt;
-		if ((o->flags & SAU_LINEP_GOAL_RATIO) != 0) {
-			o->flags |= SAU_LINEP_STATE_RATIO;
-		} else {
-			o->flags &= ~SAU_LINEP_STATE_RATIO;
-		}
-		o->flags &= ~(SAU_LINEP_GOAL | SAU_LINEP_GOAL_RATIO);
+	if (!(o->flags & SAU_LINEP_GOAL)) {
+		advance_len(o, skip_len);
 		return false;
 	}
-	return (o->flags & SAU_LINEP_GOAL) != 0;
+	for (;;) {
+		uint32_t len = 0;
+		if (o->pos < o->end) {
+			len = o->end - o->pos;
+			if (len > skip_len) len = skip_len;
+			o->pos += len;
+		}
+		if (o->pos < o->end)
+			return true;
+		skip_len -= len;
+		if (!next_seg(o))
+			break;
+	}
+	/*
+	 * Goal reached; turn into new state value.
+	 */
+	o->v0 = o->vt;
+	o->pos = 0;
+	if ((o->flags & SAU_LINEP_GOAL_RATIO) != 0) {
+		o->flags |= SAU_LINEP_STATE_RATIO;
+	} else {
+		o->flags &= ~SAU_LINEP_STATE_RATIO;
+	}
+	o->flags &= ~(SAU_LINEP_GOAL | SAU_LINEP_GOAL_RATIO | SAU_LINEP_TIME);
+	return false;
 }
@@ -38,6 +38,8 @@ void sauLine_fill_##NAME(float *restrict buf, uint32_t len, \
 		const float *restrict mulbuf); \
 void sauLine_map_##NAME(float *restrict buf, uint32_t len, \
 		const float *restrict end0, const float *restrict end1); \
+void sauLine_seg_##NAME(float *restrict buf, uint32_t len, \
+		float a, float b); \
 /*float sauLine_val_##NAME(float x, float a, float b);*/ /* inlined */ \
 /**/
 #define SAU_LINE__X_FILL_ADDR(NAME, ...) sauLine_fill_##NAME,
@@ -88,6 +90,13 @@ extern const sauLine_fill_f sauLine_fill_funcs[SAU_LINE_NAMED];
  */
 extern const sauLine_map_f sauLine_map_funcs[SAU_LINE_NAMED];
 
+/*
+ * Segment functions for line type shapes, named sauLine_seg_*().
+ *
+ * Like the map functions, but for a segment with the same ends \p a and
+ * \p b for all \p len positions in \p buf, e.g. a random segment cycle.
+ */
+
 /**
  * Single value functions for line type shapes. See comments per function.
  */
@@ -106,11 +115,26 @@ enum {
 	SAU_LINEP_TIME_IF_NEW = 1<<6, // time_ms to be kept if currently set
 };
 
+/**
+ * Further segment for a line, following after its goal is reached.
+ * Each segment begins at the goal of the one before it.
+ */
+typedef struct sauLineSeg {
+	float vt;
+	uint32_t time_ms;
+	uint8_t type;
+	uint8_t flags; // SAU_LINEP_TIME_IF_NEW if time_ms is a default
+} sauLineSeg;
+
 /**
  * Line parameter type.
  *
  * Holds data for parameters with support for gradual change,
  * both during script processing and audio rendering.
+ *
+ * A goal can be followed by a list of further segments, which
+ * are walked in turn when running the line, like breakpoints
+ * of an envelope. The list is shared, not copied, by lines.
  */
 typedef struct sauLine {
 	float v0, vt;
@@ -118,6 +142,10 @@ typedef struct sauLine {
 	uint32_t time_ms;
 	uint8_t type;
 	uint8_t flags;
+	uint16_t seg_count; // number of segments in segs
+	const sauLineSeg *segs; // further segments after goal, if any
+	uint32_t srate; // for segment times, set by setup or copy
+	uint16_t seg; // next segment to use after the current goal
 } sauLine;
 
 /**
@@ -132,6 +160,8 @@ typedef struct sauLine {
 /** Needed before get, run, or skip when a line is not copy-initialized. */
 static inline void sauLine_setup(sauLine *restrict o, uint32_t srate) {
 	o->end = sau_ms_in_samples(o->time_ms, srate, NULL);
+	o->srate = srate;
+	o->seg = 0;
 }
 void sauLine_copy(sauLine *restrict o,
 		const sauLine *restrict src,
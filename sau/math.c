@@ -43,6 +43,7 @@ static double sau_seed(struct sauMath_state *restrict o, double x) {
 static double sau_time(struct sauMath_state *restrict o) {
 	if (o->no_time)
 		return 0.0;
+	o->time_used = true;
 	/*
 	 * Before converting time value to double,
 	 * ensure it's not too large to preserve a
@@ -240,6 +240,7 @@ struct sauMath_state {
 	uint64_t seed64;
 	uint32_t seed32;
 	bool no_time;
+	bool time_used; // set when time() has given a varying value
 };
 
 /** Math function parameter type values. */
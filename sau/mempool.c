@@ -33,7 +33,7 @@
 #define ALIGN_SIZE(size) (((size) + (ALIGN_BYTES - 1)) & ~(ALIGN_BYTES - 1))
 
 typedef struct MemBlock {
-	size_t free;
+	size_t free, size;
 	char *mem;
 } MemBlock;
 
@@ -44,10 +44,12 @@ typedef struct DtorItem {
 } DtorItem;
 
 struct sauMempool {
+	MemBlock head;
 	MemBlock *a;
 	size_t count, first_i, a_len;
 	size_t block_size, skip_size;
 	DtorItem *last_dtor;
+	size_t requested, padding, reserved, largest;
 };
 
 /*
@@ -79,30 +81,6 @@ static bool upsize(sauMempool *restrict o) {
 }
 
 #if !SAU_MEM_DEBUG
-/*
- * Allocate new memory block, initialized to zero bytes.
- *
- * \return allocated memory, or NULL on allocation failure
- */
-static void *add(sauMempool *restrict o, size_t size_used) {
-	if (o->count == o->a_len && !upsize(o))
-		return NULL;
-	size_t block_size = o->block_size;
-	if (block_size < size_used) block_size = size_used;
-	char *mem = calloc(1, block_size);
-	if (!mem)
-		return NULL;
-	size_t i = o->count++;
-	o->a[i].free = block_size - size_used;
-	o->a[i].mem = mem;
-	/*
-	 * Skip fully used blocks in binary searches.
-	 */
-	while (o->first_i < o->count && o->a[o->first_i].free <= o->skip_size)
-		++o->first_i;
-	return mem + o->a[i].free;
-}
-
 /*
  * Locate the first block with the smallest size into which \p size fits,
  * using binary search. If found, \p id will be set to the id.
@@ -165,6 +143,59 @@ static void copy_up_one(sauMempool *restrict o,
 		o->a[higher_from] = o->a[from];
 	}
 }
+
+/*
+ * Insert \p b into the block array, keeping the order by free space.
+ * The array must have room for one more block.
+ */
+static void insert(sauMempool *restrict o, const MemBlock *restrict b) {
+	size_t i = o->count;
+	first_greater(o, b->free, &i);
+	memmove(&o->a[i + 1], &o->a[i], sizeof(MemBlock) * (o->count - i));
+	o->a[i] = *b;
+	++o->count;
+	/*
+	 * Skip fully used blocks in binary searches.
+	 */
+	while (o->first_i < o->count && o->a[o->first_i].free <= o->skip_size)
+		++o->first_i;
+}
+
+/*
+ * Allocate new memory block, using \p size_used of it. The new block
+ * becomes the head if it has more free space left than the old head;
+ * whichever block doesn't is moved into the block array.
+ *
+ * \return allocated memory, or NULL on allocation failure
+ */
+static void *add(sauMempool *restrict o, size_t size_used) {
+	size_t total = o->count + (o->head.mem != NULL);
+	if (total == o->a_len && !upsize(o))
+		return NULL;
+	size_t block_size = o->block_size;
+	if (block_size < size_used) block_size = size_used;
+	char *mem = malloc(block_size);
+	if (!mem)
+		return NULL;
+	o->reserved += block_size;
+	MemBlock b = {block_size - size_used, block_size, mem};
+	if (b.free > o->head.free || !o->head.mem) {
+		if (o->head.mem) insert(o, &o->head);
+		o->head = b;
+	} else {
+		insert(o, &b);
+	}
+	return mem + b.free;
+}
+
+/*
+ * Compare blocks by size, for sorting from largest to smallest.
+ */
+static int cmp_size_desc(const void *a, const void *b) {
+	size_t a_size = ((const MemBlock*) a)->size;
+	size_t b_size = ((const MemBlock*) b)->size;
+	return (a_size < b_size) - (a_size > b_size);
+}
 #endif
 
 /**
@@ -209,34 +240,105 @@ void sau_destroy_Mempool(sauMempool *restrict o) {
 	for (size_t i = 0; i < o->count; ++i) {
 		free(o->a[i].mem);
 	}
+	free(o->head.mem);
 	free(o->a);
 	free(o);
 }
 
+/**
+ * Reset instance for reuse, dropping all allocations at once.
+ *
+ * Any destructor functions registered are called beforehand, in the
+ * reverse order of registration, as upon destruction. Then the largest
+ * memory blocks, as many as needed to hold the total size allocated,
+ * are kept for reuse; the rest are freed.
+ *
+ * Allocation works the same after a reset. The largest kept block is
+ * bumped from first, and the others take what doesn't fit in it.
+ * Allocating about as much again won't need any new memory blocks.
+ */
+void sau_mpreset(sauMempool *restrict o) {
+	for (DtorItem *n = o->last_dtor; n; n = n->prev) {
+		n->func(n->arg);
+	}
+	o->last_dtor = NULL;
+#if !SAU_MEM_DEBUG
+	size_t used = 0, kept = 0, keep_count = 0;
+	if (o->head.mem) {
+		o->a[o->count++] = o->head;
+		o->head = (MemBlock){0};
+	}
+	for (size_t i = 0; i < o->count; ++i) {
+		used += o->a[i].size - o->a[i].free;
+	}
+	if (o->count > 1)
+		qsort(o->a, o->count, sizeof(MemBlock), cmp_size_desc);
+	for (; keep_count < o->count && kept < used; ++keep_count) {
+		MemBlock *b = &o->a[keep_count];
+		b->free = b->size;
+		kept += b->size;
+	}
+	o->reserved = kept;
+	for (size_t i = keep_count; i < o->count; ++i) {
+		free(o->a[i].mem);
+	}
+	o->count = 0;
+	o->first_i = 0;
+	if (keep_count > 0) {
+		o->head = o->a[0];
+		/*
+		 * Restore ascending order of free space for binary search.
+		 */
+		for (size_t i = 1, j = keep_count; i + 1 < j; ++i, --j) {
+			MemBlock tmp = o->a[i];
+			o->a[i] = o->a[j - 1];
+			o->a[j - 1] = tmp;
+		}
+		o->count = keep_count - 1;
+		memmove(&o->a[0], &o->a[1], sizeof(MemBlock) * o->count);
+	}
+#else /* SAU_MEM_DEBUG */
+	for (size_t i = 0; i < o->count; ++i) {
+		free(o->a[i].mem);
+	}
+	o->count = 0;
+	o->reserved = 0;
+#endif
+	o->requested = o->padding = o->largest = 0;
+}
+
 /**
  * Allocate block of \p size within the memory pool,
- * initialized to zero bytes.
+ * leaving its contents uninitialized. For use when
+ * the memory will be fully written before reading.
  *
  * \return allocated memory, or NULL on allocation failure
  */
-void *sau_mpalloc(sauMempool *restrict o, size_t size) {
+void *sau_mpalloc_uninit(sauMempool *restrict o, size_t size) {
 #if !SAU_MEM_DEBUG
 	size_t i = o->count;
 	void *mem;
+	o->requested += size;
+	if (size > o->largest) o->largest = size;
+	o->padding += ALIGN_SIZE(size) - size;
 	size = ALIGN_SIZE(size);
 	/*
-	 * If blocks exist and the most spacious can hold the size,
+	 * Fast path: bump from the head block while it has room.
+	 */
+	if (size <= o->head.free) {
+		o->head.free -= size;
+		return o->head.mem + o->head.free;
+	}
+	/*
+	 * If other blocks exist and the most spacious can hold the size,
 	 * pick least-free-space best fit using binary search.
 	 * Otherwise, use a new block.
 	 */
-	if (first_smallest(o, size, &i)) {
-		o->a[i].free -= size;
-		mem = o->a[i].mem + o->a[i].free;
-	} else {
-		mem = add(o, size);
-		if (!mem)
-			return NULL;
+	if (!first_smallest(o, size, &i)) {
+		return add(o, size);
 	}
+	o->a[i].free -= size;
+	mem = o->a[i].mem + o->a[i].free;
 	/*
 	 * Sort blocks after allocation so that binary search will work.
 	 */
@@ -270,8 +372,85 @@ void *sau_mpalloc(sauMempool *restrict o, size_t size) {
 	if (!mem)
 		return NULL;
 	o->a[o->count++].mem = mem;
+	o->requested += size;
+	o->reserved += size;
+	if (size > o->largest) o->largest = size;
+	return mem;
+#endif
+}
+
+/**
+ * Allocate block of \p size within the memory pool,
+ * initialized to zero bytes.
+ *
+ * \return allocated memory, or NULL on allocation failure
+ */
+void *sau_mpalloc(sauMempool *restrict o, size_t size) {
+	void *mem = sau_mpalloc_uninit(o, size);
+	if (!mem)
+		return NULL;
+#if !SAU_MEM_DEBUG
+	memset(mem, 0, size);
+#endif
 	return mem;
+}
+
+/**
+ * Allocate block of \p size within the memory pool,
+ * initialized to zero bytes, with the start address
+ * a multiple of \p align. For larger alignment than
+ * that of other allocations, e.g. 32 or 64 bytes, to
+ * suit SIMD loads or keep data within cache lines.
+ *
+ * \p align must be a power of two.
+ *
+ * \return allocated memory, or NULL on allocation failure
+ */
+void *sau_mpalloc_aligned(sauMempool *restrict o,
+		size_t size, size_t align) {
+	if (align <= ALIGN_BYTES)
+		return sau_mpalloc(o, size);
+	size_t extra = align - ALIGN_BYTES;
+	char *mem;
+#if !SAU_MEM_DEBUG
+	size_t a_size = ALIGN_SIZE(size);
+	/*
+	 * Bump from the head block if there's room after rounding
+	 * the address down. Otherwise, allocate with enough extra
+	 * to round the address up, counting the extra as padding.
+	 */
+	if (a_size <= o->head.free) {
+		uintptr_t top = (uintptr_t) (o->head.mem + o->head.free);
+		uintptr_t start = (top - a_size) & ~(uintptr_t) (align - 1);
+		if (start >= (uintptr_t) o->head.mem) {
+			o->requested += size;
+			if (size > o->largest) o->largest = size;
+			o->padding += (top - start) - size;
+			o->head.free = start - (uintptr_t) o->head.mem;
+			mem = o->head.mem + o->head.free;
+			memset(mem, 0, size);
+			return mem;
+		}
+	}
+	size_t largest = o->largest;
+	if (size > SIZE_MAX - extra ||
+	    !(mem = sau_mpalloc_uninit(o, size + extra)))
+		return NULL;
+	o->requested -= extra;
+	o->padding += extra;
+	o->largest = (size > largest) ? size : largest;
+#else /* SAU_MEM_DEBUG */
+	/*
+	 * Over-allocate to round the address up; the start
+	 * of the allocation is kept for freeing.
+	 */
+	if (size > SIZE_MAX - extra ||
+	    !(mem = sau_mpalloc_uninit(o, size + extra)))
+		return NULL;
 #endif
+	mem += (align - ((uintptr_t) mem & (align - 1))) & (align - 1);
+	memset(mem, 0, size);
+	return mem;
 }
 
 /**
@@ -283,11 +462,12 @@ void *sau_mpalloc(sauMempool *restrict o, size_t size) {
  */
 void *sau_mpmemdup(sauMempool *restrict o,
 		const void *restrict src, size_t size) {
-	void *mem = sau_mpalloc(o, size);
+	if (!src)
+		return sau_mpalloc(o, size);
+	void *mem = sau_mpalloc_uninit(o, size);
 	if (!mem)
 		return NULL;
-	if (src != NULL)
-		memcpy(mem, src, size);
+	memcpy(mem, src, size);
 	return mem;
 }
 
@@ -310,3 +490,25 @@ bool sau_mpregdtor(sauMempool *restrict o,
 	o->last_dtor = n;
 	return true;
 }
+
+/**
+ * Get allocation statistics for the memory pool, as counted since
+ * creation or the last reset. The waste is the sum of padding added
+ * for alignment and free space left in blocks skipped as full.
+ */
+void sau_mp_stats(const sauMempool *restrict o,
+		sauMempoolStats *restrict st) {
+	size_t waste = o->padding;
+#if !SAU_MEM_DEBUG
+	for (size_t i = 0; i < o->first_i; ++i) {
+		waste += o->a[i].free;
+	}
+	st->blocks = o->count + (o->head.mem != NULL);
+#else /* SAU_MEM_DEBUG */
+	st->blocks = o->count;
+#endif
+	st->requested = o->requested;
+	st->reserved = o->reserved;
+	st->waste = waste;
+	st->largest = o->largest;
+}
@@ -23,10 +23,28 @@ typedef struct sauMempool sauMempool;
 
 sauMempool *sau_create_Mempool(size_t start_size) sauMalloclike;
 void sau_destroy_Mempool(sauMempool *restrict o);
+void sau_mpreset(sauMempool *restrict o);
 
 void *sau_mpalloc(sauMempool *restrict o, size_t size) sauMalloclike;
+void *sau_mpalloc_uninit(sauMempool *restrict o, size_t size) sauMalloclike;
+void *sau_mpalloc_aligned(sauMempool *restrict o,
+		size_t size, size_t align) sauMalloclike;
 void *sau_mpmemdup(sauMempool *restrict o,
 		const void *restrict src, size_t size) sauMalloclike;
 typedef void (*sauDtor_f)(void *o);
 bool sau_mpregdtor(sauMempool *restrict o,
 		sauDtor_f func, void *restrict arg);
+
+/**
+ * Memory pool statistics. Sizes are in bytes.
+ */
+typedef struct sauMempoolStats {
+	size_t requested; // sum of allocation sizes requested
+	size_t reserved; // sum of memory block sizes
+	size_t blocks; // number of memory blocks
+	size_t waste; // alignment padding and space left in full blocks
+	size_t largest; // largest allocation size requested
+} sauMempoolStats;
+
+void sau_mp_stats(const sauMempool *restrict o,
+		sauMempoolStats *restrict st);
@@ -13,10 +13,12 @@
 
 #include <sau/scanner.h>
 #include <sau/script.h>
+#include <sau/builder.h>
 #include <sau/help.h>
 #include <sau/math.h>
 #include <sau/arrtype.h>
 #include "parser/parseconv.h"
+#include <stdlib.h>
 
 /*
  * File-reading code
@@ -87,11 +89,30 @@ static const sauScriptOptions def_sopt = {
 	.key_system = 0,
 };
 
-static bool init_ScanLookup(struct ScanLookup *restrict o,
-		const sauScriptArg *restrict arg,
-		sauSymtab *restrict st) {
-	o->sopt = def_sopt;
-	if (!sauSymtab_add_stra(st, sauMath_names, SAU_MATH_NAMED,
+/*
+ * Symbol table for names built into the script language, shared
+ * as a read-only base by the symbol tables of all parses.
+ */
+static const sauSymtab *builtin_symtab = NULL;
+
+/**
+ * Build the symbol table for names built into the script language,
+ * kept until the program exits. Must be called before any script is
+ * parsed, and before starting any threads which parse scripts. The
+ * table is only read afterwards, so it is then safe to share. Not
+ * thread-safe itself.
+ *
+ * If already initialized, return without doing anything.
+ *
+ * \return true, or false on allocation failure
+ */
+bool sau_global_init_Parser(void) {
+	if (builtin_symtab != NULL)
+		return true;
+	sauMempool *mp = sau_create_Mempool(0);
+	sauSymtab *st = sau_create_Symtab(mp, NULL);
+	if (!st ||
+	    !sauSymtab_add_stra(st, sauMath_names, SAU_MATH_NAMED,
 			SAU_SYM_MATH_ID, 0) ||
 	    !sauSymtab_add_stra(st, sauMath_vars_names, SAU_MATH_VARS_NAMED,
 			SAU_SYM_VAR, 1 /* has ID only if > 0 */) ||
@@ -100,8 +121,18 @@ static bool init_ScanLookup(struct ScanLookup *restrict o,
 	    !sauSymtab_add_stra(st, sauWave_names, SAU_WAVE_NAMED,
 			SAU_SYM_WAVE_ID, 0) ||
 	    !sauSymtab_add_stra(st, sauNoise_names, SAU_NOISE_NAMED,
-			SAU_SYM_NOISE_ID, 0))
+			SAU_SYM_NOISE_ID, 0)) {
+		sau_destroy_Mempool(mp);
 		return false;
+	}
+	builtin_symtab = st;
+	return true;
+}
+
+static bool init_ScanLookup(struct ScanLookup *restrict o,
+		const sauScriptArg *restrict arg,
+		sauSymtab *restrict st) {
+	o->sopt = def_sopt;
 	/*
 	 * Register predefined values as variable assignments.
 	 */
@@ -786,25 +817,39 @@ struct NestScope {
 	sauScriptOptions sopt_save; /* save/restore on nesting */
 	/* values passed for outer parameter */
 	sauLine *op_sweep;
+	size_t segs_from; /* where op_sweep segments begin in parser's segs */
+	bool in_seg; /* set if after first segment for op_sweep */
+	sauScanFrame seg_sf; /* where segment was begun, if still without goal */
+	bool seg_no_goal;
 	sauScanNumConst_f numconst_f;
 	bool num_ratio;
 };
 
 sauArrType(NestArr, struct NestScope, )
 sauArrType(ObjInfoArr, sauScriptObjInfo, _)
+sauArrType(LabelArr, sauSymitem*, _)
+sauArrType(SegArr, sauLineSeg, _)
 
+/*
+ * Parser state. Memory is divided into three pools: \a mp for parse
+ * data kept to the end (symbols and objects labels refer to), \a tmp_mp
+ * for nodes, reset after each duration group at the top level has been
+ * converted, and \a prg_mp for program data, including parsed lines.
+ */
 typedef struct sauParser {
 	struct ScanLookup sl;
 	sauScanner *sc;
 	sauSymtab *st;
-	sauMempool *mp, *tmp_mp;
+	sauMempool *mp, *tmp_mp, *prg_mp;
 	NestArr nest;
 	/* node state */
 	struct ParseLevel *cur_pl;
-	sauScriptEvData *events, *last_event, *group_event;
+	sauScriptEvData *last_event, *group_event;
 	bool script_fail;
 	uint32_t root_op_obj;
 	ObjInfoArr obj_arr;
+	LabelArr labels; // set to objects since last node pool reset
+	SegArr segs; // line segments being parsed, for each nested list
 	ParseConv pc;
 } sauParser;
 
@@ -814,33 +859,42 @@ typedef struct sauParser {
 static void fini_Parser(sauParser *restrict o) {
 	sau_destroy_Scanner(o->sc);
 	sau_destroy_Mempool(o->tmp_mp);
+	sau_destroy_Mempool(o->prg_mp);
 	sau_destroy_Mempool(o->mp);
 	NestArr_clear(&o->nest);
 	_ObjInfoArr_clear(&o->obj_arr);
+	_LabelArr_clear(&o->labels);
+	_SegArr_clear(&o->segs);
 }
 
 /*
  * Initialize parser instance.
  *
  * The same symbol table and script-set data will be used
- * until the instance is finalized.
+ * until the instance is finalized. Prints any error.
  *
- * \return true, or false on allocation failure
+ * \return true, or false on error
  */
 static bool init_Parser(sauParser *restrict o,
 		const sauScriptArg *restrict script_arg) {
+	if (!builtin_symtab) {
+		sau_error("parser", "sau_global_init_Parser() not called");
+		return false;
+	}
 	sauMempool *mp = sau_create_Mempool(0),
-		    *tmp_mp = sau_create_Mempool(0);
-	sauSymtab *st = sau_create_Symtab(mp);
+		    *tmp_mp = sau_create_Mempool(0),
+		    *prg_mp = sau_create_Mempool(0);
+	sauSymtab *st = sau_create_Symtab(mp, builtin_symtab);
 	sauScanner *sc = sau_create_Scanner(st);
-	*o = (sauParser){.sc = sc, .st = st, .mp = mp, .tmp_mp = tmp_mp,
-		.pc = {.mp = mp}};
-	if (!sc || !tmp_mp) goto ERROR;
+	*o = (sauParser){.sc = sc, .st = st,
+		.mp = mp, .tmp_mp = tmp_mp, .prg_mp = prg_mp};
+	if (!sc || !tmp_mp || !prg_mp) goto ERROR;
 	if (!init_ScanLookup(&o->sl, script_arg, st)) goto ERROR;
 	sc->filters['#'] = scan_filter_hashcommands;
 	sc->data = &o->sl;
 	return true;
 ERROR:
+	sau_error("parser", "memory allocation failure");
 	fini_Parser(o);
 	return false;
 }
@@ -913,7 +967,7 @@ static sauScriptObjInfo *ObjInfoArr_add(ObjInfoArr *restrict o,
 static sauLine *create_line(sauParser *restrict o,
 		bool mult, uint32_t par_flag) {
 	struct ScanLookup *sl = &o->sl;
-	sauLine *line = sau_mpalloc(o->mp, sizeof(*line));
+	sauLine *line = sau_mpalloc(o->prg_mp, sizeof(*line));
 	float v0 = 0.f;
 	if (!line)
 		return NULL;
@@ -1007,7 +1061,7 @@ static void begin_event(sauParser *restrict o,
 	struct ParseLevel *pl = o->cur_pl;
 	sauScriptEvData *e;
 	end_event(o);
-	pl->event = sau_mpalloc(o->mp, sizeof(sauScriptEvData));
+	pl->event = sau_mpalloc(o->tmp_mp, sizeof(sauScriptEvData));
 	e = pl->event;
 	e->wait_ms = pl->add_wait_ms + pl->carry_wait_ms;
 	pl->add_wait_ms = pl->carry_wait_ms = 0;
@@ -1031,9 +1085,7 @@ static void begin_event(sauParser *restrict o,
 		}
 	}
 	if (!is_compstep) {
-		if (!o->events)
-			o->events = e;
-		else
+		if (o->last_event != NULL)
 			o->last_event->next = e;
 		o->last_event = e;
 		pl->main_ev = NULL;
@@ -1057,12 +1109,29 @@ static void prepare_event(sauParser *restrict o,
 		begin_event(o, prev_obj, is_compstep);
 }
 
+/*
+ * Set \p label to refer to \p obj, listing it for moving the object
+ * out of the node pool before a reset.
+ */
+static void set_label_obj(sauParser *restrict o,
+		sauSymitem *restrict label, void *restrict obj) {
+	sauSymitem **item = _LabelArr_add(&o->labels);
+	if (!item) {
+		label->data_use = SAU_SYM_DATA_NONE;
+		return;
+	}
+	*item = label;
+	label->data_use = SAU_SYM_DATA_OBJ;
+	label->data.obj = obj;
+}
+
 /*
  * Add new object to parent(s), ie. either the current event node,
  * or an object ref node (either ordinary or representing multiple
  * objects) in the case of object linking/nesting.
  */
-static void link_ev_obj(struct ParseLevel *restrict pl,
+static void link_ev_obj(sauParser *restrict o,
+		struct ParseLevel *restrict pl,
 		struct NestScope *restrict nest,
 		sauScriptObjRef *restrict obj,
 		sauScriptObjRef *restrict prev) {
@@ -1085,8 +1154,7 @@ static void link_ev_obj(struct ParseLevel *restrict pl,
 	 * Assign to label?
 	 */
 	if (pl->set_label != NULL) {
-		pl->set_label->data_use = SAU_SYM_DATA_OBJ;
-		pl->set_label->data.obj = obj;
+		set_label_obj(o, pl->set_label, obj);
 		pl->set_label = NULL;
 	}
 }
@@ -1100,7 +1168,7 @@ static void begin_list(sauParser *restrict o,
 	(void)plist;
 	struct ParseLevel *pl = o->cur_pl, *parent_pl = pl->parent;
 	struct NestScope *nest = NestArr_tip(&o->nest);
-	nest->list = sau_mpalloc(o->mp, sizeof(*nest->list));
+	nest->list = sau_mpalloc(o->tmp_mp, sizeof(*nest->list));
 	pl->sub_f = nest->op_sweep ? parse_in_par_sweep : NULL;
 	nest->list->use_type = use_type;
 	sauScriptObjInfo *info;
@@ -1111,7 +1179,7 @@ static void begin_list(sauParser *restrict o,
 				SAU_POBJT_LIST, 0);
 	//}
 	if (use_type == SAU_POP_N_carr) {
-		link_ev_obj(parent_pl, NestArr_getrev(&o->nest, 1),
+		link_ev_obj(o, parent_pl, NestArr_getrev(&o->nest, 1),
 				&nest->list->ref, &plist->ref);
 	} else {
 		sauScriptOpData *parent_on = parent_pl->operator;
@@ -1133,7 +1201,7 @@ static void begin_operator(sauParser *restrict o,
 	sauScriptEvData *e = pl->event;
 	sauScriptOpData *op;
 	end_operator(o);
-	pl->operator = op = sau_mpalloc(o->mp, sizeof(sauScriptOpData));
+	pl->operator = op = sau_mpalloc(o->tmp_mp, sizeof(sauScriptOpData));
 	if (!is_compstep)
 		pl->pl_flags |= PL_NEW_EVENT_FORK;
 	pl->used_ampmult = o->sl.sopt.def_ampmult;
@@ -1141,6 +1209,9 @@ static void begin_operator(sauParser *restrict o,
 	 * Initialize node.
 	 */
 	if (pop != NULL) {
+		sauScriptObjInfo *info = &o->obj_arr.a[pop->ref.obj_id];
+		if (info->ref_count != SAU_SOBJ_REFS_KEEP)
+			++info->ref_count;
 		op->ref = pop->ref;
 		op->prev_ref = pop;
 		op->op_flags = pop->op_flags &
@@ -1166,6 +1237,7 @@ static void begin_operator(sauParser *restrict o,
 		bool is_nested = pl->use_type != SAU_POP_N_carr;
 		sauScriptObjInfo *info = ObjInfoArr_add(&o->obj_arr, &op->ref,
 				SAU_POBJT_OP, type);
+		info->ref_count = 1;
 		if (sau_pop_has_seed(type))
 			op->seed = info->seed = sau_rand32(&o->sl.math_state);
 		op->time = sauTime_DEFAULT(o->sl.sopt.def_time_ms, is_nested);
@@ -1183,7 +1255,9 @@ static void begin_operator(sauParser *restrict o,
 			op->ref.obj_id;
 		op->amp = create_line(o, false, SAU_PSWEEP_AMP);
 	}
-	link_ev_obj(pl, nest, &op->ref, &pop->ref);
+	if (pl->set_label != NULL) /* keep object for label use */
+		o->obj_arr.a[op->ref.obj_id].ref_count = SAU_SOBJ_REFS_KEEP;
+	link_ev_obj(o, pl, nest, &op->ref, &pop->ref);
 	op->event = e;
 	pl->pl_flags |= PL_OWN_OP;
 }
@@ -1199,6 +1273,58 @@ static void finish_durgroup(sauParser *restrict o) {
 		return; /* nothing to do */
 	o->last_event = time_durgroup(o, o->group_event, &pl->carry_wait_ms);
 	o->group_event = NULL;
+	if (!o->script_fail)
+		ParseConv_stream_part(&o->pc, &o->sl.sopt,
+				o->sc->f->path, false);
+}
+
+/*
+ * Copy the object \p obj to \p dst, or to new memory in the parse pool
+ * if NULL, keeping what following references use, but not the links to
+ * other nodes.
+ *
+ * \return copy, or NULL on allocation failure
+ */
+static void *keep_node(sauParser *restrict o,
+		void *restrict dst, const sauScriptObjRef *restrict obj) {
+	bool is_op = obj->obj_type == SAU_POBJT_OP;
+	size_t size = is_op ?
+		sizeof(sauScriptOpData) :
+		sizeof(sauScriptListData);
+	sauScriptObjRef *copy = dst;
+	if (!copy && !(copy = sau_mpalloc(o->mp, size)))
+		return NULL;
+	memcpy(copy, obj, size);
+	copy->next = NULL;
+	if (is_op) {
+		sauScriptOpData *op = (sauScriptOpData*) copy;
+		op->event = NULL;
+		op->prev_ref = NULL;
+		op->mods = NULL;
+	} else {
+		((sauScriptListData*) copy)->first_item = NULL;
+	}
+	return copy;
+}
+
+/*
+ * Drop the nodes of the duration groups converted, resetting the node
+ * pool, after a duration group at the top level. Objects which labels
+ * refer to are first copied to the parse pool.
+ */
+static void drop_nodes(sauParser *restrict o) {
+	for (size_t i = 0; i < o->labels.count; ++i) {
+		sauSymitem *label = o->labels.a[i];
+		void *copy = keep_node(o, NULL, label->data.obj);
+		if (!copy) {
+			label->data_use = SAU_SYM_DATA_NONE;
+			continue;
+		}
+		label->data.obj = copy;
+	}
+	o->labels.count = 0;
+	o->last_event = NULL;
+	sau_mpreset(o->tmp_mp);
 }
 
 static void enter_level(sauParser *restrict o,
@@ -1219,7 +1345,8 @@ static void enter_level(sauParser *restrict o,
 		pl->operator = parent_pl->operator;
 		if (newscope == SCOPE_BIND) {
 			struct NestScope *nest = NestArr_tip(&o->nest);
-			nest->list = sau_mpalloc(o->mp, sizeof(*nest->list));
+			nest->list = sau_mpalloc(o->tmp_mp,
+					sizeof(*nest->list));
 			pl->sub_f = NULL;
 		} else if (newscope == SCOPE_NEST) {
 			struct NestScope *nest = NestArr_tip(&o->nest);
@@ -1255,6 +1382,9 @@ static void leave_level(sauParser *restrict o) {
 		end_event(o);
 		finish_durgroup(o);
 		ParseConv_end_dur_ms(&o->pc);
+		if (!o->script_fail)
+			ParseConv_stream_part(&o->pc, &o->sl.sopt,
+					o->sc->f->path, true);
 	}
 	if (pl->scope == SCOPE_GROUP) {
 		end_event(o);
@@ -1440,14 +1570,99 @@ static void parse_in_settings(sauParser *restrict o) {
 static bool parse_level(sauParser *restrict o,
 		uint8_t use_type, uint8_t newscope, uint8_t close_c);
 
+/*
+ * Add a further segment to the line of \p nest, after its goal. Values
+ * not set for it later are copied from the segment before it. Segments
+ * are gathered in the parser's array, for end_line_segs() to set.
+ *
+ * \return segment, or NULL on failure
+ */
+static sauLineSeg *add_line_seg(sauParser *restrict o,
+		struct NestScope *restrict nest) {
+	sauLine *line = nest->op_sweep;
+	size_t count = o->segs.count - nest->segs_from;
+	if (count == 0 && line->seg_count > 0) {
+		/* continue segments from an earlier list for the line */
+		count = line->seg_count;
+		if (!_SegArr_upsize(&o->segs, nest->segs_from + count))
+			return NULL;
+		memcpy(&o->segs.a[nest->segs_from], line->segs,
+				count * sizeof(*line->segs));
+		o->segs.count += count;
+	}
+	if (count == UINT16_MAX) {
+		sauScanner_warning(o->sc, NULL,
+"too many line segments, limit is %d", UINT16_MAX);
+		return NULL;
+	}
+	sauLineSeg *seg = _SegArr_add(&o->segs);
+	if (!seg)
+		return NULL;
+	if (count > 0) {
+		*seg = seg[-1];
+	} else {
+		seg->vt = line->vt;
+		seg->time_ms = line->time_ms;
+		seg->type = line->type;
+		seg->flags = line->flags & SAU_LINEP_TIME_IF_NEW;
+	}
+	return seg;
+}
+
+/*
+ * Set the segments parsed for the line of \p nest, copying them once
+ * from the parser's array into program memory, and drop them there.
+ *
+ * \return true, or false on allocation failure
+ */
+static bool end_line_segs(sauParser *restrict o,
+		struct NestScope *restrict nest) {
+	sauLine *line = nest->op_sweep;
+	size_t count = o->segs.count - nest->segs_from;
+	if (count == 0)
+		return true;
+	o->segs.count = nest->segs_from;
+	sauLineSeg *segs = sau_mpmemdup(o->prg_mp,
+			&o->segs.a[nest->segs_from], count * sizeof(*segs));
+	if (!segs)
+		return false;
+	line->segs = segs;
+	line->seg_count = count;
+	return true;
+}
+
 static void parse_in_par_sweep(sauParser *restrict o) {
 	struct NestScope *nest = NestArr_tip(&o->nest);
 	sauLine *line = nest->op_sweep;
 	PARSE_IN__HEAD(parse_in_par_sweep, true)
+		sauLineSeg *seg = nest->in_seg ? _SegArr_tip(&o->segs) : NULL;
 		double val;
 		switch (c) {
+		case ',':
+			if (!(line->flags & SAU_LINEP_GOAL)) {
+				sauScanner_warning(sc, NULL,
+"ignoring ',' for line segment without goal before it");
+				break;
+			}
+			if (seg != NULL && nest->seg_no_goal) {
+				sauScanner_warning(sc, NULL,
+"ignoring ',' for line segment without goal before it");
+				break;
+			}
+			if (add_line_seg(o, nest) != NULL) {
+				nest->in_seg = true;
+				nest->seg_sf = sf_first;
+				nest->seg_no_goal = true;
+			}
+			pl->pl_flags &= ~PL_WARN_NOSPACE; /* OK around */
+			continue;
 		case 'g':
 			if (scan_num(sc, nest->numconst_f, &val)) {
+				if (seg != NULL) {
+					seg->vt = val;
+					nest->seg_no_goal = false;
+					break;
+				}
 				line->vt = val;
 				line->flags |= SAU_LINEP_GOAL;
 				if (nest->num_ratio)
@@ -1464,10 +1679,19 @@ static void parse_in_par_sweep(sauParser *restrict o) {
 			if (!scan_sym_id(sc, &id, SAU_SYM_LINE_ID,
 						sauLine_names))
 				break;
+			if (seg != NULL) {
+				seg->type = id;
+				break;
+			}
 			line->type = id;
 			line->flags |= SAU_LINEP_TYPE;
 			break; }
 		case 't':
+			if (seg != NULL) {
+				if (scan_time_val(sc, &seg->time_ms))
+					seg->flags &= ~SAU_LINEP_TIME_IF_NEW;
+				break;
+			}
 			if (scan_time_val(sc, &line->time_ms))
 				line->flags &= ~SAU_LINEP_TIME_IF_NEW;
 			break;
@@ -1495,6 +1719,8 @@ static bool prepare_sweep(sauParser *restrict o,
 		(*op_sweep)->flags &= ~(SAU_LINEP_STATE | SAU_LINEP_TYPE);
 	}
 	nest->op_sweep = *op_sweep;
+	nest->segs_from = o->segs.count;
+	nest->in_seg = false;
 	nest->numconst_f = numconst_f;
 	nest->num_ratio = ratio;
 	return true;
@@ -1515,6 +1741,15 @@ static void parse_par_list(sauParser *restrict o,
 		if (clear) clear = false;
 		else nest->list->append = true;
 	}
+	if (nest->in_seg && nest->seg_no_goal) {
+		sauScanner_warning(o->sc, &nest->seg_sf,
+"ignoring ',' for line segment without goal after it");
+		--o->segs.count;
+	}
+	if (nest->in_seg && !end_line_segs(o, nest)) {
+		sau_error("parser", "memory allocation failure");
+		o->script_fail = true;
+	}
 	NestArr_pop(&o->nest);
 }
 
@@ -1903,6 +2138,7 @@ static bool parse_level(sauParser *restrict o,
 		case SAU_SCAN_SPACE:
 		case SAU_SCAN_LNBRK:
 			pl.pl_flags &= ~PL_WARN_NOSPACE;
+			sauScanner_skipws(sc); // skip any run in one go
 			continue;
 		case '$':
 			if (parse_numvar_lhs(o))
@@ -1975,7 +2211,7 @@ static bool parse_level(sauParser *restrict o,
 						op = pl.operator;
 						pl.sub_f = parse_in_op_step;
 					}
-					label->data.obj = op; /* update */
+					set_label_obj(o, label, op); /* update */
 				} else {
 					sauScanner_warning(sc, NULL,
 "label '@%s' doesn't refer to any object", label->sstr->key);
@@ -2033,6 +2269,10 @@ static bool parse_level(sauParser *restrict o,
 			pl.pl_flags &= ~PL_WARN_NOSPACE; /* OK around */
 			end_event(o);
 			finish_durgroup(o);
+			if (!pl.parent) {
+				pl.main_ev = NULL;
+				drop_nodes(o);
+			}
 			pl.sub_f = NULL;
 			continue;
 		case '}':
@@ -2068,7 +2308,7 @@ static const char *parse_file(sauParser *restrict o,
 		const sauScriptArg *restrict arg) {
 	sauScanner *sc = o->sc;
 	const char *name;
-	if (!sauScanner_open(sc, arg->str, arg->is_path)) {
+	if (!sauScanner_open(sc, arg->str, arg->is_path, arg->name)) {
 		return NULL;
 	}
 	parse_level(o, SAU_POP_N_carr, SCOPE_GROUP, 0);
@@ -2084,8 +2324,9 @@ static const char *parse_file(sauParser *restrict o,
 
 /**
  * Create internal program for the given script file. Includes a pointer
- * to \p parse as \a parse, unless \p keep_parse is false, in which case
- * the parse is destroyed after the conversion regardless of the result.
+ * to the parse as \a parse, unless the \a keep_parse option is false,
+ * in which case the parse (with its symbol table) is destroyed after the
+ * conversion. Program data is built in a pool of its own in either case.
  *
  * \return instance or NULL on error preventing parse
  */
@@ -2096,33 +2337,77 @@ sau_build_Program(const sauScriptArg *restrict arg) {
 	sauParser pr;
 	sauProgram *o = NULL;
 	sauScript *parse;
+	sauMempoolStats script_mem = {0};
 	if (!init_Parser(&pr, arg))
 		return NULL;
 	if (!(parse = sau_mpalloc(pr.mp, sizeof(*parse))) ||
-	    !init_ParseConv(&pr.pc, pr.mp)) goto DONE;
+	    !init_ParseConv(&pr.pc, pr.prg_mp, NULL, NULL)) goto DONE;
 	const char *name = parse_file(&pr, arg);
 	if (!name || !_ObjInfoArr_mpmemdup(&pr.obj_arr, &parse->objects, pr.mp))
 		goto DONE;
 	parse->st = pr.st;
-	parse->events = pr.events;
 	parse->name = name;
 	parse->sopt = pr.sl.sopt;
 	parse->object_count = pr.obj_arr.count;
+	sau_mp_stats(pr.mp, &script_mem);
 DONE:
-	if ((o = fini_ParseConv(&pr.pc, parse)) != NULL)
-		pr.mp = NULL; // keep with result
+	if ((o = fini_ParseConv(&pr.pc, parse)) != NULL) {
+		o->script_mem = script_mem.requested;
+		o->time_used = pr.sl.math_state.time_used;
+		sau_mp_stats(pr.tmp_mp, &o->parse_mem);
+		sauSymtab_get_stats(pr.st, &o->sym_stats);
+		if (!arg->keep_parse) {
+			o->parse = NULL;
+		} else if (sau_mpregdtor(pr.prg_mp,
+					(sauDtor_f) sau_destroy_Mempool, pr.mp)) {
+			pr.mp = NULL; // keep with result
+		} else {
+			sau_error("parser", "memory allocation failure");
+			o->parse = NULL;
+		}
+		pr.prg_mp = NULL; // keep with result
+	}
 	fini_Parser(&pr);
 	return o;
 }
 
 /**
- * Destroy instance.
+ * Build program for the given script file in parts, passing each on to
+ * \p stream_f as soon as the timing of its events is final. A part ends
+ * with each duration group, so the length of those in the script sets
+ * how far ahead it is read before the events are passed on. The last
+ * part, lacking SAU_PMODE_STREAM, is passed at the end of the script.
+ *
+ * Unlike for sau_build_Program(), no events are kept after being passed
+ * on. As when building, parse nodes are dropped after each top-level
+ * duration group, but other data referenced by events is only valid
+ * until the last part returns.
+ *
+ * Only the memory for events is bounded by part length. Other program
+ * data (ID arrays, lines and segments) and per-object parse info are
+ * kept until the end, and grow with the length of the script. Without
+ * any top-level duration group ended, the whole script is one part.
+ *
+ * \return true, or false on error preventing or stopping the parse
  */
-void
-sau_discard_Program(sauProgram *restrict o) {
-	if (!o)
-		return;
-	sau_destroy_Mempool(o->mp);
+bool
+sau_stream_Program(const sauScriptArg *restrict arg,
+		sauProgramStream_f stream_f, void *restrict data) {
+	if (!arg || !stream_f)
+		return false;
+	sauParser pr;
+	bool ok = false;
+	if (!init_Parser(&pr, arg))
+		return false;
+	if (!init_ParseConv(&pr.pc, pr.prg_mp, stream_f, data)) {
+		sau_error("parser", "memory allocation failure");
+		goto DONE;
+	}
+	ok = (parse_file(&pr, arg) != NULL) && !pr.pc.stream_stop;
+DONE:
+	fini_ParseConv(&pr.pc, NULL);
+	fini_Parser(&pr);
+	return ok;
 }
 
 static inline void time_line(sauLine *restrict line,
@@ -2133,6 +2418,12 @@ static inline void time_line(sauLine *restrict line,
 		line->time_ms = default_time_ms;
 		line->flags |= SAU_LINEP_TIME;
 	}
+	/* segments made here, so not yet shared; update the same way */
+	sauLineSeg *segs = (sauLineSeg*) line->segs;
+	for (uint32_t i = 0; i < line->seg_count; ++i) {
+		if (segs[i].flags & SAU_LINEP_TIME_IF_NEW)
+			segs[i].time_ms = default_time_ms;
+	}
 }
 
 static void time_op_lines(sauScriptOpData *restrict op);
@@ -2189,7 +2480,8 @@ static sauScriptEvData *time_durgroup(sauParser *restrict o,
 					e->dur_ms = op->time.v_ms;
 				time_op_lines(op);
 			}
-			sauVoAlloc_update(&o->pc.va, o->obj_arr.a, e);
+			sauVoAlloc_update(&o->pc.va, &o->pc.vq,
+					&o->pc.oa, o->obj_arr.a, e);
 		}
 		ParseConv_convert_event(&o->pc, o->obj_arr.a, e);
 		ParseConv_sum_dur_ms(&o->pc, e->wait_ms);
@@ -2377,3 +2669,616 @@ static void flatten_events(sauScriptEvData *restrict e) {
 	}
 	e->forks = fork->prev;
 }
+
+/*
+ * Program builder
+ */
+
+typedef struct BuilderObj {
+	sauScriptOpData *node; // latest for operator, NULL if none or released
+	sauScriptOpData *keep; // node copy kept across node pool resets
+} BuilderObj;
+
+sauArrType(BuilderObjArr, BuilderObj, _)
+sauArrType(ObjIdArr, uint32_t, _)
+
+/*
+ * Builder state. Uses the parser state for the nodes and their
+ * conversion, without a scanner or symbol table, in place of a
+ * parse level for the event and timing state of the top level.
+ */
+struct sauBuilder {
+	sauParser pr;
+	BuilderObjArr objs; // per object, by ID
+	ObjIdArr new_ops; // with nodes made since last node pool reset
+	uint32_t add_wait_ms, carry_wait_ms; /* added for next event */
+	const char *name;
+};
+
+/* Modulator use type for each swept parameter, checked for both. */
+static const uint8_t par_use_types[SAU_PSWEEP_PMA + 1] = {
+	[SAU_PSWEEP_PAN] = SAU_POP_N_camod,
+	[SAU_PSWEEP_AMP] = SAU_POP_N_amod,
+	[SAU_PSWEEP_AMP2] = SAU_POP_N_ramod,
+	[SAU_PSWEEP_FREQ] = SAU_POP_N_fmod,
+	[SAU_PSWEEP_FREQ2] = SAU_POP_N_rfmod,
+	[SAU_PSWEEP_PMA] = SAU_POP_N_apmod,
+};
+
+static void Builder_mem_error(sauBuilder *restrict o) {
+	sau_error("builder", "memory allocation failure");
+	o->pr.script_fail = true;
+}
+
+/*
+ * Get builder data for operator handle \p op, if valid and unreleased.
+ */
+static BuilderObj *Builder_get_obj(sauBuilder *restrict o, uint32_t op) {
+	if (op >= o->objs.count || !o->objs.a[op].node) {
+		sau_warning("builder", "invalid operator handle %u", op);
+		return NULL;
+	}
+	return &o->objs.a[op];
+}
+
+/*
+ * Get the latest node for operator handle \p op, which must be made
+ * since the node pool was last reset, i.e. within the duration group.
+ */
+static sauScriptOpData *Builder_get_node(sauBuilder *restrict o,
+		uint32_t op) {
+	BuilderObj *bo = Builder_get_obj(o, op);
+	if (!bo)
+		return NULL;
+	if (bo->node == bo->keep) {
+		sau_warning("builder",
+"operator %u not added or updated since duration group ended", op);
+		return NULL;
+	}
+	return bo->node;
+}
+
+/*
+ * Set \p node as the latest for object \p id, listing it as new.
+ *
+ * \return true, or false on allocation failure
+ */
+static bool Builder_set_node(sauBuilder *restrict o,
+		uint32_t id, sauScriptOpData *restrict node) {
+	BuilderObj *bo = &o->objs.a[id];
+	if (bo->node == bo->keep && !_ObjIdArr_push(&o->new_ops, &id))
+		return false;
+	bo->node = node;
+	return true;
+}
+
+static sauScriptObjInfo *Builder_add_obj(sauBuilder *restrict o,
+		sauScriptObjRef *restrict ref,
+		uint8_t obj_type, uint8_t op_type) {
+	if (!_BuilderObjArr_add(&o->objs))
+		return NULL;
+	sauScriptObjInfo *info = ObjInfoArr_add(&o->pr.obj_arr, ref,
+			obj_type, op_type);
+	if (!info)
+		--o->objs.count;
+	return info;
+}
+
+/*
+ * Check whether the operator of \p node takes modulators with
+ * \p use_type, and the parameter used with them if any.
+ */
+static bool Builder_check_use(const sauScriptOpData *restrict node,
+		uint8_t use_type) {
+	switch (use_type) {
+	case SAU_POP_N_camod:
+		if (!(node->op_flags & SAU_SDOP_NESTED)) return true;
+		break;
+	case SAU_POP_N_amod:
+	case SAU_POP_N_ramod:
+		return true;
+	case SAU_POP_N_fmod:
+	case SAU_POP_N_rfmod:
+	case SAU_POP_N_pmod:
+	case SAU_POP_N_apmod:
+	case SAU_POP_N_fpmod:
+		if (sau_pop_is_osc(node->ref.op_type)) return true;
+		break;
+	}
+	sau_warning("builder", "operator %u lacks modulator use type %u",
+			node->ref.obj_id, use_type);
+	return false;
+}
+
+/*
+ * Begin a new event at the top level, after the wait time added.
+ *
+ * \return event, or NULL on allocation failure
+ */
+static sauScriptEvData *Builder_begin_event(sauBuilder *restrict o,
+		const sauScriptOpData *restrict prev_data) {
+	sauParser *pr = &o->pr;
+	sauScriptEvData *e = sau_mpalloc(pr->tmp_mp, sizeof(*e));
+	if (!e)
+		return NULL;
+	e->wait_ms = o->add_wait_ms + o->carry_wait_ms;
+	o->add_wait_ms = o->carry_wait_ms = 0;
+	if (prev_data != NULL && (prev_data->op_flags & SAU_SDOP_NESTED))
+		e->ev_flags |= SAU_SDEV_IMPLICIT_TIME;
+	if (pr->last_event != NULL)
+		pr->last_event->next = e;
+	pr->last_event = e;
+	if (!pr->group_event)
+		pr->group_event = e;
+	return e;
+}
+
+/*
+ * Get the line for parameter \p par of \p node, or add one with
+ * values kept unset if missing. As in a script, where the second
+ * line of a pair is named after the first (e.g. "a.r"), both are
+ * then present.
+ *
+ * \return line, or NULL on allocation failure
+ */
+static sauLine *Builder_get_line(sauBuilder *restrict o,
+		sauScriptOpData *restrict node, uint8_t par) {
+	sauLine **line_p = NULL;
+	switch (par) {
+	case SAU_PSWEEP_PAN: line_p = &node->pan; break;
+	case SAU_PSWEEP_AMP2:
+		if (!Builder_get_line(o, node, SAU_PSWEEP_AMP)) return NULL;
+		/* fall-through */
+	case SAU_PSWEEP_AMP:
+		line_p = (par == SAU_PSWEEP_AMP) ? &node->amp : &node->amp2;
+		break;
+	case SAU_PSWEEP_FREQ2:
+		if (!Builder_get_line(o, node, SAU_PSWEEP_FREQ)) return NULL;
+		/* fall-through */
+	case SAU_PSWEEP_FREQ:
+		line_p = (par == SAU_PSWEEP_FREQ) ? &node->freq : &node->freq2;
+		break;
+	case SAU_PSWEEP_PMA: line_p = &node->pm_a; break;
+	}
+	if (!*line_p) { /* create for updating, values not set kept unset */
+		bool ratio = (node->op_flags & SAU_SDOP_NESTED) &&
+			(par == SAU_PSWEEP_FREQ || par == SAU_PSWEEP_FREQ2);
+		if (!(*line_p = create_line(&o->pr, ratio, par))) {
+			Builder_mem_error(o);
+			return NULL;
+		}
+		(*line_p)->flags &= ~(SAU_LINEP_STATE | SAU_LINEP_TYPE);
+	}
+	return *line_p;
+}
+
+/*
+ * Get the last list of modulators with \p use_type for \p node,
+ * or add a new list if there's none or a \p clear one is wanted.
+ * The line of the parameter modulated, if any, is also added if
+ * missing, like when a script names the parameter for the list.
+ *
+ * \return list, or NULL on error
+ */
+static sauScriptListData *Builder_get_list(sauBuilder *restrict o,
+		sauScriptOpData *restrict node,
+		uint8_t use_type, bool clear) {
+	if (!Builder_check_use(node, use_type))
+		return NULL;
+	for (uint8_t par = 0; par <= SAU_PSWEEP_PMA; ++par) {
+		if (par_use_types[par] == use_type &&
+		    !Builder_get_line(o, node, par))
+			return NULL;
+	}
+	sauScriptListData *list = NULL, *last = NULL;
+	for (sauScriptListData *l = node->mods; l != NULL; l = l->ref.next) {
+		if (l->use_type == use_type)
+			list = l;
+		last = l;
+	}
+	if (list != NULL && !clear)
+		return list;
+	sauScriptObjInfo *info;
+	if (!(list = sau_mpalloc(o->pr.tmp_mp, sizeof(*list))) ||
+	    !(info = Builder_add_obj(o, &list->ref, SAU_POBJT_LIST, 0))) {
+		Builder_mem_error(o);
+		return NULL;
+	}
+	info->parent_op_obj = node->ref.obj_id;
+	list->use_type = use_type;
+	list->append = !clear;
+	if (!last)
+		node->mods = list;
+	else
+		last->ref.next = list;
+	return list;
+}
+
+/**
+ * Create instance for building a program named \p name. The script
+ * options \p sopt give the defaults used for new operators, and the
+ * amplitude multipliers, the default one applying to carriers only.
+ * If NULL, the defaults for a script are used.
+ *
+ * \return instance, or NULL on allocation failure
+ */
+sauBuilder *sau_create_Builder(const char *restrict name,
+		const sauScriptOptions *restrict sopt) {
+	sauBuilder *o = calloc(1, sizeof(*o));
+	if (!o)
+		return NULL;
+	sauParser *pr = &o->pr;
+	if (!name)
+		name = "";
+	if (!(pr->mp = sau_create_Mempool(0)) ||
+	    !(pr->tmp_mp = sau_create_Mempool(0)) ||
+	    !(pr->prg_mp = sau_create_Mempool(0)) ||
+	    !(o->name = sau_mpmemdup(pr->prg_mp, name, strlen(name) + 1)) ||
+	    !init_ParseConv(&pr->pc, pr->prg_mp, NULL, NULL)) {
+		sau_destroy_Builder(o);
+		return NULL;
+	}
+	pr->sl.sopt = sopt ? *sopt : def_sopt;
+	return o;
+}
+
+/**
+ * Destroy instance, without building a program.
+ */
+void sau_destroy_Builder(sauBuilder *restrict o) {
+	if (!o)
+		return;
+	fini_ParseConv(&o->pr.pc, NULL);
+	fini_Parser(&o->pr);
+	_BuilderObjArr_clear(&o->objs);
+	_ObjIdArr_clear(&o->new_ops);
+	free(o);
+}
+
+/**
+ * End the last duration group, build the program, and destroy
+ * the instance. Like for a script, no parse data is kept, apart
+ * from the memory use statistics.
+ *
+ * \return program, or NULL on error
+ */
+sauProgram *sau_finish_Builder(sauBuilder *restrict o) {
+	if (!o)
+		return NULL;
+	sauParser *pr = &o->pr;
+	sauProgram *prg;
+	sauBuilder_end_group(o);
+	ParseConv_end_dur_ms(&pr->pc);
+	sauScript parse = {.sopt = pr->sl.sopt, .name = o->name};
+	if ((prg = fini_ParseConv(&pr->pc,
+			pr->script_fail ? NULL : &parse)) != NULL) {
+		prg->parse = NULL;
+		sau_mp_stats(pr->tmp_mp, &prg->parse_mem);
+		pr->prg_mp = NULL; // keep with result
+	}
+	sau_destroy_Builder(o);
+	return prg;
+}
+
+/**
+ * Add \p wait_ms to the time waited before the next event.
+ */
+void sauBuilder_wait(sauBuilder *restrict o, uint32_t wait_ms) {
+	o->add_wait_ms += wait_ms;
+}
+
+/**
+ * End the current duration group, like '|' in a script. The timing
+ * of its events is then final, and they're converted, the nodes made
+ * then dropped. Any wait time added and not yet used is discarded.
+ *
+ * \return true, or false on error in building so far
+ */
+bool sauBuilder_end_group(sauBuilder *restrict o) {
+	sauParser *pr = &o->pr;
+	o->add_wait_ms = 0; /* reset by each '|' boundary */
+	if (pr->group_event != NULL && !pr->script_fail)
+		time_durgroup(pr, pr->group_event, &o->carry_wait_ms);
+	pr->group_event = NULL;
+	for (size_t i = 0; i < o->new_ops.count; ++i) {
+		BuilderObj *bo = &o->objs.a[o->new_ops.a[i]];
+		if (!bo->node)
+			continue; // released
+		if (!(bo->keep = keep_node(pr, bo->keep, &bo->node->ref)))
+			Builder_mem_error(o);
+		bo->node = bo->keep;
+	}
+	o->new_ops.count = 0;
+	drop_nodes(pr);
+	return !pr->script_fail;
+}
+
+/**
+ * Add a new operator of \p type. If \p parent is SAU_POP_NO_ID, it's
+ * a carrier, placed in a new event. Otherwise, it's a modulator added
+ * with \p use_type for the latest node of the parent, in the same event.
+ *
+ * Parameters have the values of a new operator in a script, until set.
+ *
+ * \return handle for operator, or SAU_POP_NO_ID on error
+ */
+uint32_t sauBuilder_add_op(sauBuilder *restrict o, uint8_t type,
+		uint32_t parent, uint8_t use_type) {
+	sauParser *pr = &o->pr;
+	sauScriptOpData *pop = NULL, *op;
+	sauScriptListData *list = NULL;
+	sauScriptEvData *e;
+	sauScriptObjInfo *info;
+	if (type >= SAU_POPT_TYPES) {
+		sau_warning("builder", "invalid operator type %u", type);
+		return SAU_POP_NO_ID;
+	}
+	if (parent != SAU_POP_NO_ID) {
+		if (!(pop = Builder_get_node(o, parent)) ||
+		    !(list = Builder_get_list(o, pop, use_type, false)))
+			return SAU_POP_NO_ID;
+		e = pop->event;
+	} else if (use_type != SAU_POP_N_carr) {
+		sau_warning("builder", "modulator use type %u without parent",
+				use_type);
+		return SAU_POP_NO_ID;
+	} else if (!(e = Builder_begin_event(o, NULL)))
+		goto MEM_ERR;
+	if (!(op = sau_mpalloc(pr->tmp_mp, sizeof(*op))) ||
+	    !(info = Builder_add_obj(o, &op->ref, SAU_POBJT_OP, type)))
+		goto MEM_ERR;
+	info->ref_count = 2; // for node, and handle until released
+	if (sau_pop_has_seed(type))
+		op->seed = info->seed = sau_rand32(&pr->sl.math_state);
+	if (type == SAU_POPT_N_raseg)
+		op->mode.ras.flags = SAU_RAS_O_LINE_SET;
+	op->time = sauTime_DEFAULT(pr->sl.sopt.def_time_ms, pop != NULL);
+	if (!pop) {
+		info->root_op_obj = info->parent_op_obj = op->ref.obj_id;
+		op->pan = create_line(pr, false, SAU_PSWEEP_PAN);
+		op->freq = create_line(pr, false, SAU_PSWEEP_FREQ);
+		op->amp = create_line(pr, false, SAU_PSWEEP_AMP);
+		if (op->amp)
+			op->amp->v0 *= pr->sl.sopt.def_ampmult;
+		e->main_obj = op;
+	} else {
+		info->root_op_obj = pr->obj_arr.a[parent].root_op_obj;
+		info->parent_op_obj = parent;
+		op->op_flags |= SAU_SDOP_NESTED;
+		op->freq = create_line(pr, true, SAU_PSWEEP_FREQ);
+		op->amp = create_line(pr, false, SAU_PSWEEP_AMP);
+		sauScriptObjRef *item = list->first_item;
+		if (!item) {
+			list->first_item = op;
+		} else {
+			while (item->next != NULL) item = item->next;
+			item->next = op;
+		}
+	}
+	if (!op->freq || !op->amp || (!pop && !op->pan) ||
+	    !Builder_set_node(o, op->ref.obj_id, op))
+		goto MEM_ERR;
+	op->params = SAU_POP_PARAMS;
+	op->event = e;
+	return op->ref.obj_id;
+MEM_ERR:
+	Builder_mem_error(o);
+	return SAU_POP_NO_ID;
+}
+
+/**
+ * Add an update node for operator \p op, placed in a new event,
+ * like a reference to it through a label in a script. Parameters
+ * are unchanged until set for the new node.
+ *
+ * \return true, or false on error
+ */
+bool sauBuilder_update_op(sauBuilder *restrict o, uint32_t op) {
+	sauParser *pr = &o->pr;
+	BuilderObj *bo = Builder_get_obj(o, op);
+	if (!bo)
+		return false;
+	sauScriptOpData *pop = bo->node, *node;
+	sauScriptEvData *e = Builder_begin_event(o, pop);
+	if (!e || !(node = sau_mpalloc(pr->tmp_mp, sizeof(*node)))) {
+		Builder_mem_error(o);
+		return false;
+	}
+	++pr->obj_arr.a[op].ref_count;
+	node->ref = pop->ref;
+	node->ref.next = NULL;
+	node->prev_ref = pop;
+	node->op_flags = pop->op_flags & SAU_SDOP_NESTED;
+	node->time = sauTime_DEFAULT(pop->time.v_ms,
+			pop->time.flags & SAU_TIMEP_IMPLICIT);
+	node->mode.main = pop->mode.main;
+	node->event = e;
+	e->main_obj = node;
+	if (!Builder_set_node(o, op, node)) {
+		Builder_mem_error(o);
+		return false;
+	}
+	return true;
+}
+
+/**
+ * Release the handle for operator \p op, after which it's no longer
+ * valid. The operator and the others in its tree can then have their
+ * IDs reused, once all are released and their voice use ends.
+ *
+ * \return true, or false if the handle is invalid
+ */
+bool sauBuilder_release_op(sauBuilder *restrict o, uint32_t op) {
+	BuilderObj *bo = Builder_get_obj(o, op);
+	if (!bo)
+		return false;
+	--o->pr.obj_arr.a[op].ref_count;
+	bo->node = NULL;
+	return true;
+}
+
+/**
+ * Clear the list of modulators with \p use_type for operator \p op.
+ * Following modulators added with the use type replace the old list.
+ *
+ * \return true, or false on error
+ */
+bool sauBuilder_clear_mods(sauBuilder *restrict o, uint32_t op,
+		uint8_t use_type) {
+	sauScriptOpData *node = Builder_get_node(o, op);
+	if (!node)
+		return false;
+	return Builder_get_list(o, node, use_type, true) != NULL;
+}
+
+/**
+ * Set the line for parameter \p par (SAU_PSWEEP_*) of operator \p op,
+ * using the parts of \p line which its flags mark as set: its state,
+ * goal and further segments, type, and time. The rest are kept, like
+ * when setting a line in a script.
+ *
+ * \return true, or false on error
+ */
+bool sauBuilder_set_line(sauBuilder *restrict o, uint32_t op,
+		uint8_t par, const sauLine *restrict line) {
+	sauParser *pr = &o->pr;
+	sauScriptOpData *node;
+	if (par > SAU_PSWEEP_PMA || !line) {
+		sau_warning("builder", "invalid line parameter %u", par);
+		return false;
+	}
+	if (line->type >= SAU_LINE_NAMED) goto INVALID;
+	for (uint32_t i = 0; i < line->seg_count; ++i) {
+		if (line->segs[i].type >= SAU_LINE_NAMED) goto INVALID;
+	}
+	if (!(node = Builder_get_node(o, op)) ||
+	    !Builder_check_use(node, par_use_types[par]))
+		return false;
+	sauLine *dst = Builder_get_line(o, node, par);
+	if (!dst)
+		return false;
+	bool nested = node->op_flags & SAU_SDOP_NESTED;
+	float mult = (!nested &&
+			(par == SAU_PSWEEP_AMP || par == SAU_PSWEEP_AMP2)) ?
+		pr->sl.sopt.def_ampmult : 1.f;
+	if (line->flags & SAU_LINEP_STATE) {
+		dst->v0 = line->v0 * mult;
+		dst->flags &= ~SAU_LINEP_STATE_RATIO;
+		dst->flags |= line->flags &
+			(SAU_LINEP_STATE | SAU_LINEP_STATE_RATIO);
+	}
+	if (line->flags & SAU_LINEP_GOAL) {
+		const sauLineSeg *segs = NULL;
+		if (line->seg_count > 0 && !(segs = sau_mpmemdup(pr->prg_mp,
+				line->segs, line->seg_count * sizeof(*segs))))
+			goto MEM_ERR;
+		dst->vt = line->vt * mult;
+		dst->segs = segs;
+		dst->seg_count = line->seg_count;
+		dst->flags &= ~SAU_LINEP_GOAL_RATIO;
+		dst->flags |= line->flags &
+			(SAU_LINEP_GOAL | SAU_LINEP_GOAL_RATIO);
+	}
+	if (line->flags & SAU_LINEP_TYPE) {
+		dst->type = line->type;
+		dst->flags |= SAU_LINEP_TYPE;
+	}
+	if (line->flags & SAU_LINEP_TIME) {
+		dst->time_ms = line->time_ms;
+		dst->flags &= ~SAU_LINEP_TIME_IF_NEW;
+	}
+	return true;
+INVALID:
+	sau_warning("builder", "invalid line type for operator %u", op);
+	return false;
+MEM_ERR:
+	Builder_mem_error(o);
+	return false;
+}
+
+/**
+ * Set the time for operator \p op.
+ *
+ * \return true, or false on error
+ */
+bool sauBuilder_set_time(sauBuilder *restrict o, uint32_t op,
+		uint32_t time_ms) {
+	sauScriptOpData *node = Builder_get_node(o, op);
+	if (!node)
+		return false;
+	node->time = sauTime_VALUE(time_ms, 0);
+	node->params |= SAU_POPP_TIME;
+	return true;
+}
+
+/**
+ * Set the phase for oscillator operator \p op, as a fixed-point
+ * cycle position (see sau_cyclepos_dtoui32()).
+ *
+ * \return true, or false on error
+ */
+bool sauBuilder_set_phase(sauBuilder *restrict o, uint32_t op,
+		uint32_t phase) {
+	sauScriptOpData *node = Builder_get_node(o, op);
+	if (!node)
+		return false;
+	if (!sau_pop_is_osc(node->ref.op_type)) {
+		sau_warning("builder", "operator %u lacks phase", op);
+		return false;
+	}
+	node->phase = phase;
+	node->params |= SAU_POPP_PHASE;
+	return true;
+}
+
+/**
+ * Set the seed for operator \p op, of a type which uses one.
+ *
+ * \return true, or false on error
+ */
+bool sauBuilder_set_seed(sauBuilder *restrict o, uint32_t op,
+		uint32_t seed) {
+	sauScriptOpData *node = Builder_get_node(o, op);
+	if (!node)
+		return false;
+	if (!sau_pop_has_seed(node->ref.op_type)) {
+		sau_warning("builder", "operator %u lacks seed", op);
+		return false;
+	}
+	node->seed = seed;
+	node->params |= SAU_POPP_SEED;
+	return true;
+}
+
+/**
+ * Set the type-specific mode data for operator \p op: the wave type,
+ * the noise type, or for random segments the line type and options.
+ *
+ * \return true, or false on error
+ */
+bool sauBuilder_set_mode(sauBuilder *restrict o, uint32_t op,
+		union sauPOPMode mode) {
+	sauScriptOpData *node = Builder_get_node(o, op);
+	if (!node)
+		return false;
+	bool valid = false;
+	switch (node->ref.op_type) {
+	case SAU_POPT_N_noise:
+		valid = mode.main < SAU_NOISE_NAMED;
+		break;
+	case SAU_POPT_N_wave:
+		valid = mode.main < SAU_WAVE_NAMED;
+		break;
+	case SAU_POPT_N_raseg:
+		valid = mode.ras.line < SAU_LINE_NAMED &&
+			mode.ras.func < SAU_RAS_FUNCTIONS;
+		break;
+	}
+	if (!valid) {
+		sau_warning("builder", "invalid mode for operator %u", op);
+		return false;
+	}
+	node->mode = mode;
+	node->params |= SAU_POPP_MODE;
+	return true;
+}
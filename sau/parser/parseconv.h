@@ -31,7 +31,7 @@ concat_ProgramIDArr(sauMempool *restrict mp,
 		return arr0;
 	size_t size0 = sizeof(uint32_t) * arr0->count;
 	size_t size1 = sizeof(uint32_t) * arr1->count;
-	sauProgramIDArr *idarr = sau_mpalloc(mp,
+	sauProgramIDArr *idarr = sau_mpalloc_uninit(mp,
 			sizeof(sauProgramIDArr) + size0 + size1);
 	if (!idarr)
 		return NULL;
@@ -47,6 +47,7 @@ concat_ProgramIDArr(sauMempool *restrict mp,
 enum {
 	SAU_VAS_HAS_CARR  = 1U<<0,
 	SAU_VAS_SET_GRAPH = 1U<<1,
+	SAU_VAS_LIST_FREE = 1U<<2, // in free list, maybe no longer free
 };
 
 /*
@@ -54,74 +55,112 @@ enum {
  */
 typedef struct sauVoAllocState {
 	uint32_t obj_id;
-	uint32_t duration_ms;
+	uint32_t end_ms; // time at which voice becomes free for reuse
 	uint32_t carr_op_id;
+	uint32_t free_op_id; // first in list of IDs to reuse for voice
 	uint32_t flags;
 } sauVoAllocState;
 
 sauArrType(sauVoAlloc, sauVoAllocState, _)
 
 /*
- * Update voices for event and return state for voice.
- *
- * Use the current voice if any, otherwise reusing an expired voice
- * if possible, or allocating a new if not.
+ * Voice queue item, ordered by key, then by voice ID.
+ */
+typedef struct sauVoQueueItem {
+	uint32_t key;
+	uint32_t vo_id;
+} sauVoQueueItem;
+
+sauArrType(sauVoHeap, sauVoQueueItem, _)
+
+/*
+ * Voice timing state, for finding free voices without a pass
+ * through all voices per event. End times are queued as voices
+ * are given them, and when passed, the voices are moved to the
+ * list of free voices, ordered by ID. Entries made outdated by
+ * changes are dropped when they come first.
+ */
+typedef struct sauVoQueue {
+	sauVoHeap ends; // min-heap of voice end times
+	sauVoHeap free; // min-heap of voice IDs
+	uint32_t time_ms;
+} sauVoQueue;
+
+static inline bool
+sauVoQueueItem_before(const sauVoQueueItem *restrict a,
+		const sauVoQueueItem *restrict b) {
+	return a->key < b->key || (a->key == b->key && a->vo_id < b->vo_id);
+}
+
+/*
+ * Add item to min-heap.
  *
- * \return current array element, or NULL on allocation failure
+ * \return true, or false on allocation failure
  */
-static sauVoAllocState *
-sauVoAlloc_update(sauVoAlloc *restrict va,
-		sauScriptObjInfo *restrict info_a,
-		sauScriptEvData *restrict e) {
-	uint32_t vo_id, obj_id;
-	/*
-	 * Count down remaining durations before voice reuse.
-	 */
-	for (uint32_t id = 0; id < va->count; ++id) {
-		if (va->a[id].duration_ms < e->wait_ms)
-			va->a[id].duration_ms = 0;
-		else
-			va->a[id].duration_ms -= e->wait_ms;
-	}
-	/*
-	 * Use voice without change if possible.
-	 */
-	sauScriptOpData *obj = e->main_obj;
-	sauScriptObjInfo *info = &info_a[(obj_id = obj->ref.obj_id)];
-	sauVoAllocState *vas;
-	if (obj->prev_ref) {
-		info = &info_a[(obj_id = info->root_op_obj)];
-		if (info->last_vo_id != SAU_PVO_NO_ID) {
-			vo_id = info->last_vo_id;
-			vas = &va->a[vo_id];
-			goto PRESERVED;
-		}
+static bool
+sauVoHeap_put(sauVoHeap *restrict o, uint32_t key, uint32_t vo_id) {
+	const sauVoQueueItem item = {key, vo_id};
+	if (!_sauVoHeap_add(o))
+		return false;
+	size_t i = o->count - 1;
+	while (i > 0) {
+		size_t parent = (i - 1) / 2;
+		if (!sauVoQueueItem_before(&item, &o->a[parent]))
+			break;
+		o->a[i] = o->a[parent];
+		i = parent;
 	}
-	e->ev_flags |= SAU_SDEV_ASSIGN_VOICE; // now new, renumbered, or reused
-	/*
-	 * Reuse first lowest free voice (duration expired), if any.
-	 */
-	for (size_t id = 0; id < va->count; ++id) {
-		vas = &va->a[id];
-		if (vas->duration_ms == 0) {
-			sauScriptObjInfo *old_info = &info_a[vas->obj_id];
-			old_info->last_vo_id = SAU_PVO_NO_ID; // renumber on use
-			*vas = (sauVoAllocState){0};
-			vo_id = id;
-			goto RECYCLED;
-		}
+	o->a[i] = item;
+	return true;
+}
+
+/*
+ * Remove first item from non-empty min-heap.
+ */
+static void
+sauVoHeap_drop_first(sauVoHeap *restrict o) {
+	const sauVoQueueItem *last = &o->a[--o->count];
+	size_t i = 0;
+	for (;;) {
+		size_t child = 2*i + 1;
+		if (child >= o->count)
+			break;
+		if (child + 1 < o->count &&
+		    sauVoQueueItem_before(&o->a[child + 1], &o->a[child]))
+			++child;
+		if (!sauVoQueueItem_before(&o->a[child], last))
+			break;
+		o->a[i] = o->a[child];
+		i = child;
 	}
-	vo_id = va->count;
-	if (!(vas = _sauVoAlloc_add(va)))
-		return NULL;
-RECYCLED:
-	info->last_vo_id = vo_id;
-	vas->obj_id = obj_id;
-PRESERVED:
-	if ((e->ev_flags & SAU_SDEV_VOICE_SET_DUR) != 0)
-		vas->duration_ms = e->dur_ms;
-	obj->ref.vo_id = vo_id;
-	return vas;
+	o->a[i] = *last;
+}
+
+/*
+ * Queue voice \p vo_id after a change of voice or end time,
+ * either by end time, or in the free list if already free.
+ *
+ * \return true, or false on allocation failure
+ */
+static bool
+sauVoQueue_add(sauVoQueue *restrict o,
+		sauVoAllocState *restrict vas, uint32_t vo_id) {
+	if (vas->end_ms > o->time_ms)
+		return sauVoHeap_put(&o->ends, vas->end_ms, vo_id);
+	if (vas->flags & SAU_VAS_LIST_FREE)
+		return true;
+	vas->flags |= SAU_VAS_LIST_FREE;
+	return sauVoHeap_put(&o->free, vo_id, vo_id);
+}
+
+/*
+ * Clear voice queue.
+ */
+static inline void
+sauVoQueue_clear(sauVoQueue *restrict o) {
+	_sauVoHeap_clear(&o->ends);
+	_sauVoHeap_clear(&o->free);
+	o->time_ms = 0;
 }
 
 /*
@@ -136,17 +175,50 @@ enum {
  */
 typedef struct sauOpAllocState {
 	const sauProgramIDArr *mods[SAU_POP_NAMED - 1];
+	uint32_t obj_id;
+	uint32_t next_id; // next in tree of top-level operator, or free list
 	uint32_t flags;
 } sauOpAllocState;
 
 sauArrType(sauOpAlloc, sauOpAllocState, _)
 
+/*
+ * Free the IDs of the tree of operators for the top-level object
+ * \p obj_id, when the voice \p vas playing it is reused for another.
+ * The IDs are listed for reuse by later operators for the same voice
+ * only, as the generator may still run the old tree for other voices
+ * handled earlier within a block.
+ *
+ * Nothing is freed if any object in the tree has references left
+ * to convert, or is kept for reference through a label; the tree
+ * could then play again, and its operators are left as they are.
+ */
+static void
+sauOpAlloc_expire(sauOpAlloc *restrict o,
+		sauScriptObjInfo *restrict info_a,
+		uint32_t obj_id, sauVoAllocState *restrict vas) {
+	sauScriptObjInfo *info = &info_a[obj_id];
+	if (info->ref_count != 0 || info->parent_op_obj != obj_id)
+		return;
+	uint32_t first_id = info->last_op_id, last_id = first_id;
+	for (uint32_t id = first_id; id != SAU_POP_NO_ID; ) {
+		sauOpAllocState *oas = &o->a[id];
+		if (info_a[oas->obj_id].ref_count != 0)
+			return;
+		last_id = id;
+		id = oas->next_id;
+	}
+	o->a[last_id].next_id = vas->free_op_id;
+	vas->free_op_id = first_id;
+}
+
 /*
  * Update operator data for event and return an operator ID in \p op_id.
  *
  * Use the current operator if any, otherwise allocating a new one.
- * (TODO: Implement tracking of expired operators (requires look at
- * nesting and use of modulators by carriers), for reusing of IDs.)
+ * IDs freed from expired operators of voice \p vas are reused first,
+ * if a voice is used. New operators are added to the tree of their
+ * top-level operator, for freeing the IDs of the tree together.
  *
  * Only valid to call for single-operator nodes.
  *
@@ -155,14 +227,36 @@ sauArrType(sauOpAlloc, sauOpAllocState, _)
 static sauScriptObjInfo *
 sauOpAlloc_update(sauOpAlloc *restrict o,
 		sauScriptObjInfo *restrict info_a,
-		const sauScriptOpData *restrict od) {
+		const sauScriptOpData *restrict od,
+		sauVoAllocState *restrict vas) {
 	sauScriptObjInfo *info = &info_a[od->ref.obj_id];
+	if (info->ref_count != SAU_SOBJ_REFS_KEEP)
+		--info->ref_count;
 	if (!od->prev_ref) {
-		uint32_t op_id = o->count;
-		sauOpAllocState *oas = _sauOpAlloc_add(o);
-		if (!oas)
-			return NULL;
+		uint32_t op_id;
+		sauOpAllocState *oas;
+		if (vas != NULL && vas->free_op_id != SAU_POP_NO_ID) {
+			op_id = vas->free_op_id;
+			oas = &o->a[op_id];
+			vas->free_op_id = oas->next_id;
+			*oas = (sauOpAllocState){0};
+		} else {
+			op_id = o->count;
+			if (!(oas = _sauOpAlloc_add(o)))
+				return NULL;
+		}
 		info->last_op_id = op_id;
+		oas->obj_id = od->ref.obj_id;
+		oas->next_id = SAU_POP_NO_ID;
+		uint32_t top_obj = info->parent_op_obj;
+		if (top_obj != od->ref.obj_id) {
+			while (info_a[top_obj].parent_op_obj != top_obj)
+				top_obj = info_a[top_obj].parent_op_obj;
+			sauOpAllocState *top_oas =
+				&o->a[info_a[top_obj].last_op_id];
+			oas->next_id = top_oas->next_id;
+			top_oas->next_id = op_id;
+		}
 		for (int i = 1; i < SAU_POP_NAMED; ++i) {
 			oas->mods[i - 1] = &blank_idarr;
 		}
@@ -178,6 +272,89 @@ sauOpAlloc_clear(sauOpAlloc *restrict o) {
 	_sauOpAlloc_clear(o);
 }
 
+/*
+ * Update voices for event and return state for voice.
+ *
+ * Use the current voice if any, otherwise reusing an expired voice
+ * if possible, or allocating a new if not. The operators of a reused
+ * voice are expired, freeing their IDs where possible.
+ *
+ * \return current array element, or NULL on allocation failure
+ */
+static sauVoAllocState *
+sauVoAlloc_update(sauVoAlloc *restrict va,
+		sauVoQueue *restrict vq,
+		sauOpAlloc *restrict oa,
+		sauScriptObjInfo *restrict info_a,
+		sauScriptEvData *restrict e) {
+	uint32_t vo_id, obj_id;
+	/*
+	 * Advance time, listing voices whose durations ran out as free.
+	 */
+	vq->time_ms += e->wait_ms;
+	while (vq->ends.count > 0 && vq->ends.a[0].key <= vq->time_ms) {
+		uint32_t end_ms = vq->ends.a[0].key;
+		vo_id = vq->ends.a[0].vo_id;
+		sauVoHeap_drop_first(&vq->ends);
+		if (va->a[vo_id].end_ms != end_ms)
+			continue; // outdated by later change
+		if (!sauVoQueue_add(vq, &va->a[vo_id], vo_id))
+			return NULL;
+	}
+	/*
+	 * Use voice without change if possible.
+	 */
+	sauScriptOpData *obj = e->main_obj;
+	sauScriptObjInfo *info = &info_a[(obj_id = obj->ref.obj_id)];
+	sauVoAllocState *vas;
+	if (obj->prev_ref) {
+		info = &info_a[(obj_id = info->root_op_obj)];
+		if (info->last_vo_id != SAU_PVO_NO_ID) {
+			vo_id = info->last_vo_id;
+			vas = &va->a[vo_id];
+			goto PRESERVED;
+		}
+	}
+	e->ev_flags |= SAU_SDEV_ASSIGN_VOICE; // now new, renumbered, or reused
+	/*
+	 * Reuse first lowest free voice (duration expired), if any.
+	 */
+	while (vq->free.count > 0) {
+		vo_id = vq->free.a[0].vo_id;
+		sauVoHeap_drop_first(&vq->free);
+		vas = &va->a[vo_id];
+		vas->flags &= ~SAU_VAS_LIST_FREE;
+		if (vas->end_ms <= vq->time_ms) {
+			sauScriptObjInfo *old_info = &info_a[vas->obj_id];
+			old_info->last_vo_id = SAU_PVO_NO_ID; // renumber on use
+			sauOpAlloc_expire(oa, info_a, vas->obj_id, vas);
+			*vas = (sauVoAllocState){.free_op_id = vas->free_op_id};
+			goto RECYCLED;
+		}
+	}
+	vo_id = va->count;
+	if (!(vas = _sauVoAlloc_add(va)))
+		return NULL;
+	vas->free_op_id = SAU_POP_NO_ID;
+RECYCLED:
+	info->last_vo_id = vo_id;
+	vas->obj_id = obj_id;
+	if ((e->ev_flags & SAU_SDEV_VOICE_SET_DUR) != 0)
+		vas->end_ms = vq->time_ms + e->dur_ms;
+	if (!sauVoQueue_add(vq, vas, vo_id))
+		return NULL;
+	goto DONE;
+PRESERVED:
+	if ((e->ev_flags & SAU_SDEV_VOICE_SET_DUR) != 0) {
+		vas->end_ms = vq->time_ms + e->dur_ms;
+		if (!sauVoQueue_add(vq, vas, vo_id))
+			return NULL;
+	}
+DONE:
+	obj->ref.vo_id = vo_id;
+	return vas;
+}
+
 sauArrType(sauPEvArr, sauProgramEvent, )
 
 sauArrType(OpRefArr, sauProgramOpRef, )
@@ -218,9 +395,15 @@ typedef struct ParseConv {
 	sauProgramEvent *ev;
 	sauVoiceGraph ev_vo_graph;
 	OpDataArr ev_op_data;
+	sauByteArr ev_op_enc;
 	sauMempool *mp;
+	sauMempool *ev_mp; // for per-event data, reset per part if streaming
 	sauVoAlloc va;
+	sauVoQueue vq;
 	uint32_t tot_dur_ms;
+	sauProgramStream_f stream_f;
+	void *stream_data;
+	bool stream_stop;
 } ParseConv;
 
 #define ParseConv_sum_dur_ms(o, add_ms) ((o)->tot_dur_ms += (add_ms))
@@ -235,8 +418,8 @@ ParseConv_end_dur_ms(ParseConv *restrict o) {
 	uint32_t remaining_ms = 0;
 	for (size_t i = 0; i < o->va.count; ++i) {
 		sauVoAllocState *vas = &o->va.a[i];
-		if (vas->duration_ms > remaining_ms)
-			remaining_ms = vas->duration_ms;
+		if (vas->end_ms > o->vq.time_ms + remaining_ms)
+			remaining_ms = vas->end_ms - o->vq.time_ms;
 	}
 	return ParseConv_sum_dur_ms(o, remaining_ms);
 }
@@ -258,7 +441,7 @@ ParseConv_convert_list(ParseConv *restrict o,
 	uint32_t count = ParseConv_count_list(list_in);
 	if (!count)
 		return &blank_idarr;
-	sauProgramIDArr *idarr = sau_mpalloc(o->mp,
+	sauProgramIDArr *idarr = sau_mpalloc_uninit(o->mp,
 			sizeof(sauProgramIDArr) + sizeof(uint32_t) * count);
 	if (!idarr)
 		return NULL;
@@ -347,7 +530,8 @@ ParseConv_convert_ops(ParseConv *restrict o,
 		// TODO: handle multiple operator nodes
 		if ((op->op_flags & SAU_SDOP_MULTIPLE) != 0) continue;
 		sauScriptObjInfo *info;
-		if (!(info = sauOpAlloc_update(&o->oa, objects, op)))
+		if (!(info = sauOpAlloc_update(&o->oa, objects, op,
+				link ? &o->va.a[o->ev->vo_id] : NULL)))
 			return false;
 		for (sauScriptListData *in_list = op->mods;
 				in_list != NULL; in_list = in_list->ref.next) {
@@ -461,6 +645,31 @@ sau_fini_VoiceGraph(sauVoiceGraph *restrict o) {
 	OpRefArr_clear(&o->vo_graph);
 }
 
+/*
+ * Set the operator data list for the current event to the operator
+ * data converted for it, in the compact encoding.
+ *
+ * \return true, or false on allocation failure
+ */
+static bool
+ParseConv_encode_opdata(ParseConv *restrict o,
+		sauProgramEvent *restrict out_ev) {
+	sauByteArr *enc = &o->ev_op_enc;
+	enc->count = 0; // reuse allocation
+	for (size_t i = 0; i < o->ev_op_data.count; ++i) {
+		if (!sauByteArr_upsize(enc, enc->count + SAU_POPDATA_ENC_MAX))
+			return false;
+		uint8_t *end = sauProgramOpData_encode(&enc->a[enc->count],
+				&o->ev_op_data.a[i]);
+		enc->count = end - enc->a;
+	}
+	if (!sauByteArr_mpmemdup(enc, (uint8_t**) &out_ev->op_data, o->ev_mp))
+		return false;
+	out_ev->op_data_count = o->ev_op_data.count;
+	out_ev->op_data_size = enc->count;
+	return true;
+}
+
 /*
  * Convert all voice and operator data for a parse event node into a
  * series of output events.
@@ -494,10 +703,7 @@ ParseConv_convert_event(ParseConv *restrict o,
 	e_objs.first_item = obj;
 	if (!ParseConv_convert_ops(o, objects, &e_objs, true)) goto MEM_ERR;
 	if (o->ev_op_data.count > 0) {
-		if (!_OpDataArr_mpmemdup(&o->ev_op_data,
-					(sauProgramOpData**) &out_ev->op_data,
-					o->mp)) goto MEM_ERR;
-		out_ev->op_data_count = o->ev_op_data.count;
+		if (!ParseConv_encode_opdata(o, out_ev)) goto MEM_ERR;
 		o->ev_op_data.count = 0; // reuse allocation
 	}
 	if (e->ev_flags & SAU_SDEV_ASSIGN_VOICE) {
@@ -508,7 +714,7 @@ ParseConv_convert_event(ParseConv *restrict o,
 	}
 	out_ev->carr_op_id = vas->carr_op_id;
 	if ((vas->flags & SAU_VAS_SET_GRAPH) != 0) {
-		if (!sauVoiceGraph_set(&o->ev_vo_graph, out_ev, o->mp))
+		if (!sauVoiceGraph_set(&o->ev_vo_graph, out_ev, o->ev_mp))
 			goto MEM_ERR;
 	}
 	return true;
@@ -523,23 +729,39 @@ MEM_ERR:
  */
 static bool
 ParseConv_check_validity(ParseConv *restrict o,
-		sauScript *restrict parse) {
+		const char *restrict name) {
 	bool error = false;
 	if (o->va.count > SAU_PVO_MAX_ID) {
 		fprintf(stderr,
 "%s: error: number of voices used cannot exceed %u\n",
-			parse->name, SAU_PVO_MAX_ID);
+			name, SAU_PVO_MAX_ID);
 		error = true;
 	}
 	if (o->oa.count > SAU_POP_MAX_ID) {
 		fprintf(stderr,
 "%s: error: number of operators used cannot exceed %u\n",
-			parse->name, SAU_POP_MAX_ID);
+			name, SAU_POP_MAX_ID);
 		error = true;
 	}
 	return !error;
 }
 
+/*
+ * Set program amplitude options, using the script options \p sopt.
+ */
+static void
+ParseConv_set_amp(sauProgram *restrict prg,
+		const sauScriptOptions *restrict sopt) {
+	prg->ampmult = sopt->ampmult;
+	if (!(sopt->set & SAU_SOPT_AMPMULT)) {
+		/*
+		 * Enable amplitude scaling (division) by voice count,
+		 * handled by audio generator.
+		 */
+		prg->mode |= SAU_PMODE_AMP_DIV_VOICES;
+	}
+}
+
 static sauProgram *
 ParseConv_create_program(ParseConv *restrict o,
 		sauScript *restrict parse) {
@@ -549,14 +771,7 @@ ParseConv_create_program(ParseConv *restrict o,
 				(sauProgramEvent**) &prg->events, o->mp))
 		goto MEM_ERR;
 	prg->ev_count = o->ev_arr.count;
-	prg->ampmult = parse->sopt.ampmult;
-	if (!(parse->sopt.set & SAU_SOPT_AMPMULT)) {
-		/*
-		 * Enable amplitude scaling (division) by voice count,
-		 * handled by audio generator.
-		 */
-		prg->mode |= SAU_PMODE_AMP_DIV_VOICES;
-	}
+	ParseConv_set_amp(prg, &parse->sopt);
 	prg->vo_count = o->va.count;
 	prg->op_count = o->oa.count;
 	prg->op_nest_depth = o->ev_vo_graph.op_nest_max;
@@ -570,32 +785,92 @@ MEM_ERR:
 	return NULL;
 }
 
+/*
+ * Pass the events converted since the last call on to the stream
+ * function as the next part of the program, if streaming. The events
+ * and their data are then dropped, reusing the memory for the next.
+ *
+ * The \p last part, which may have no events, ends the stream. Until
+ * then, parts are only passed on when there are new events to pass.
+ * Following a failure, or a stop requested by the stream function,
+ * further parts are dropped without being passed on.
+ *
+ * \return true, or false if streaming is stopped
+ */
+static bool
+ParseConv_stream_part(ParseConv *restrict o,
+		const sauScriptOptions *restrict sopt,
+		const char *restrict name, bool last) {
+	if (!o->stream_f || o->stream_stop)
+		return !o->stream_stop;
+	if (o->ev_arr.count == 0 && !last)
+		return true;
+	if (!ParseConv_check_validity(o, name)) {
+		o->stream_stop = true;
+	} else {
+		sauProgram part = {0};
+		part.events = o->ev_arr.a;
+		part.ev_count = o->ev_arr.count;
+		part.mode = last ? 0 : SAU_PMODE_STREAM;
+		ParseConv_set_amp(&part, sopt);
+		part.vo_count = o->va.count;
+		part.op_count = o->oa.count;
+		part.op_nest_depth = o->ev_vo_graph.op_nest_max;
+		part.duration_ms = o->tot_dur_ms;
+		part.name = name;
+		if (!o->stream_f(o->stream_data, &part))
+			o->stream_stop = true;
+	}
+	o->ev_arr.count = 0; // reuse allocation
+	sau_mpreset(o->ev_mp);
+	return !o->stream_stop;
+}
+
+/*
+ * Initialize instance for use. If \p stream_f is not NULL,
+ * the program is passed on to it in parts as it's built,
+ * instead of being gathered for fini_ParseConv().
+ *
+ * \return true, or false on allocation failure
+ */
 static bool
 init_ParseConv(ParseConv *restrict o,
-		sauMempool *restrict mp) {
-	o->mp = mp;
+		sauMempool *restrict mp,
+		sauProgramStream_f stream_f, void *restrict stream_data) {
+	o->mp = o->ev_mp = mp;
+	if (stream_f != NULL) {
+		if (!(o->ev_mp = sau_create_Mempool(0)))
+			return false;
+		o->stream_f = stream_f;
+		o->stream_data = stream_data;
+	}
 	sau_init_VoiceGraph(&o->ev_vo_graph, &o->va, &o->oa);
 	return true;
 }
 
 /*
- * Build program using the gathered data, after conversion calls.
+ * Build program using the gathered data, after conversion calls,
+ * unless \p parse is NULL. Clears the instance in either case.
  */
 static sauProgram *
 fini_ParseConv(ParseConv *restrict o,
 		sauScript *restrict parse) {
 	sauProgram *prg = NULL;
-	if (ParseConv_check_validity(o, parse)) {
+	if (parse != NULL && ParseConv_check_validity(o, parse->name)) {
 		if (!(prg = ParseConv_create_program(o, parse))) goto MEM_ERR;
 	}
 	if (false)
 	MEM_ERR: {
 		sau_error("parseconv", "memory allocation failure");
 	}
+	if (o->stream_f != NULL) sau_destroy_Mempool(o->ev_mp);
+	o->ev_mp = NULL;
 	sau_fini_VoiceGraph(&o->ev_vo_graph);
 	_OpDataArr_clear(&o->ev_op_data);
+	sauByteArr_clear(&o->ev_op_enc);
 	sauOpAlloc_clear(&o->oa);
 	_sauVoAlloc_clear(&o->va);
+	sauVoQueue_clear(&o->vq);
 	sauPEvArr_clear(&o->ev_arr);
 	return prg;
 }
@@ -654,6 +929,10 @@ print_line(const sauLine *restrict line, char c) {
 		else
 			sau_printf("\t%c", c);
 	}
+	if ((line->flags & SAU_LINEP_GOAL) != 0) {
+		for (uint32_t i = 0; i < line->seg_count; ++i)
+			sau_printf("->%-6.2f", line->segs[i].vt);
+	}
 }
 
 #define SAU_POPT__X_CASE(NAME, LABELC) \
@@ -703,8 +982,10 @@ sauProgram_print_info(const sauProgram *restrict o) {
 				"\n\tvo %u", ev->vo_id);
 			print_oplist(ev->op_list, ev->op_count);
 		}
+		const uint8_t *od_src = ev->op_data;
 		for (size_t i = 0; i < ev->op_data_count; ++i) {
-			const sauProgramOpData *od = &ev->op_data[i];
+			sauProgramOpData od_buf, *od = &od_buf;
+			od_src = sauProgramOpData_decode(od, od_src);
 			print_opline(od);
 			SAU_POP__ITEMS(SAU_POP__X_PRINT)
 		}
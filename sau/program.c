@@ -0,0 +1,620 @@
+/* SAU library: Audio program data and functions.
+ * Copyright (c) 2011-2013, 2017-2024 Joel K. Pettersson
+ * <joelkp@tuta.io>.
+ *
+ * This file and the software of which it is part is distributed under the
+ * terms of the GNU Lesser General Public License, either version 3 or (at
+ * your option) any later version, WITHOUT ANY WARRANTY, not even of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * View the files COPYING.LESSER and COPYING for details, or if missing, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SAU_PROGRAM_MMAP
+/*
+ * Map program image files into memory when loading, where supported?
+ */
+# if defined(__unix__) || (defined(__APPLE__) && defined(__MACH__))
+#  define SAU_PROGRAM_MMAP 1
+# else
+#  define SAU_PROGRAM_MMAP 0
+# endif
+#endif
+#if SAU_PROGRAM_MMAP
+# define _POSIX_C_SOURCE 200809L
+#endif
+#include <sau/program.h>
+#include <sau/arrtype.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#if SAU_PROGRAM_MMAP
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <unistd.h>
+#endif
+
+/*
+ * Compact operator data encoding.
+ *
+ * Each item starts with the operator ID as a varint, the use type and
+ * type bytes, and a varint mask of the fields present. The fields set
+ * (non-NULL or non-zero) follow in mask order, first the pointers for
+ * lines and ID arrays, stored whole, then the other fields; numbers
+ * are stored as varints, except for phase and seed which use all bits.
+ */
+
+#define OD_LINE_ITEMS(X) \
+	X(pan) \
+	X(amp) \
+	X(amp2) \
+	X(freq) \
+	X(freq2) \
+	X(pm_a) \
+	//
+
+enum {
+	OD_LINES = 6,
+	OD_PTRS = OD_LINES + (SAU_POP_NAMED - 1),
+	OD_F_PARAMS = 1U<<(OD_PTRS + 0),
+	OD_F_TIME   = 1U<<(OD_PTRS + 1),
+	OD_F_PHASE  = 1U<<(OD_PTRS + 2),
+	OD_F_SEED   = 1U<<(OD_PTRS + 3),
+	OD_F_MODE   = 1U<<(OD_PTRS + 4),
+};
+
+/*
+ * Get the pointer fields, lines first and then ID arrays, in order.
+ */
+static void get_od_ptrs(const sauProgramOpData *restrict od,
+		const void **restrict ptrs) {
+	size_t i = 0;
+#define GET_LINE(NAME) ptrs[i++] = od->NAME;
+	OD_LINE_ITEMS(GET_LINE)
+#undef GET_LINE
+#define GET_IDARR(NAME, IS_MOD, ...) SAU_IF(IS_MOD, ptrs[i++] = od->NAME##s;, )
+	SAU_POP__ITEMS(GET_IDARR)
+#undef GET_IDARR
+}
+
+static inline uint8_t *put_varint(uint8_t *restrict dst, uint32_t val) {
+	while (val >= 0x80) {
+		*dst++ = (val & 0x7f) | 0x80;
+		val >>= 7;
+	}
+	*dst++ = val;
+	return dst;
+}
+
+static inline const uint8_t *get_varint(const uint8_t *restrict src,
+		uint32_t *restrict val) {
+	uint32_t v = 0;
+	for (unsigned shift = 0; ; shift += 7) {
+		uint8_t c = *src++;
+		v |= (uint32_t) (c & 0x7f) << shift;
+		if (!(c & 0x80)) break;
+	}
+	*val = v;
+	return src;
+}
+
+/**
+ * Write operator data to \p dst in the compact encoding, using
+ * at most SAU_POPDATA_ENC_MAX bytes.
+ *
+ * \return end of data written
+ */
+uint8_t *sauProgramOpData_encode(uint8_t *restrict dst,
+		const sauProgramOpData *restrict od) {
+	static const union sauPOPMode blank_mode;
+	const void *ptrs[OD_PTRS];
+	uint32_t mask = 0;
+	get_od_ptrs(od, ptrs);
+	for (int i = 0; i < OD_PTRS; ++i)
+		if (ptrs[i] != NULL) mask |= 1U<<i;
+	if (od->params != 0) mask |= OD_F_PARAMS;
+	if (od->time.v_ms != 0 || od->time.flags != 0) mask |= OD_F_TIME;
+	if (od->phase != 0) mask |= OD_F_PHASE;
+	if (od->seed != 0) mask |= OD_F_SEED;
+	if (memcmp(&od->mode, &blank_mode, sizeof(blank_mode)) != 0)
+		mask |= OD_F_MODE;
+	dst = put_varint(dst, od->id);
+	*dst++ = od->use_type;
+	*dst++ = od->type;
+	dst = put_varint(dst, mask);
+	for (int i = 0; i < OD_PTRS; ++i) {
+		if (!ptrs[i]) continue;
+		memcpy(dst, &ptrs[i], sizeof(ptrs[i]));
+		dst += sizeof(ptrs[i]);
+	}
+	if (mask & OD_F_PARAMS) dst = put_varint(dst, od->params);
+	if (mask & OD_F_TIME) {
+		dst = put_varint(dst, od->time.v_ms);
+		*dst++ = od->time.flags;
+	}
+	if (mask & OD_F_PHASE) {
+		memcpy(dst, &od->phase, sizeof(od->phase));
+		dst += sizeof(od->phase);
+	}
+	if (mask & OD_F_SEED) {
+		memcpy(dst, &od->seed, sizeof(od->seed));
+		dst += sizeof(od->seed);
+	}
+	if (mask & OD_F_MODE) {
+		memcpy(dst, &od->mode, sizeof(od->mode));
+		dst += sizeof(od->mode);
+	}
+	return dst;
+}
+
+/*
+ * Read the start of encoded operator data, up to the pointers.
+ *
+ * \return position of first pointer
+ */
+static const uint8_t *decode_od_head(sauProgramOpData *restrict od,
+		const uint8_t *restrict src, uint32_t *restrict mask) {
+	src = get_varint(src, &od->id);
+	od->use_type = *src++;
+	od->type = *src++;
+	return get_varint(src, mask);
+}
+
+/**
+ * Read operator data in the compact encoding from \p src,
+ * written by sauProgramOpData_encode(), into \p od.
+ *
+ * \return end of data read
+ */
+const uint8_t *sauProgramOpData_decode(sauProgramOpData *restrict od,
+		const uint8_t *restrict src) {
+	const void *ptrs[OD_PTRS] = {0};
+	uint32_t mask;
+	*od = (sauProgramOpData){0};
+	src = decode_od_head(od, src, &mask);
+	for (int i = 0; i < OD_PTRS; ++i) {
+		if (!(mask & (1U<<i))) continue;
+		memcpy(&ptrs[i], src, sizeof(ptrs[i]));
+		src += sizeof(ptrs[i]);
+	}
+	int i = 0;
+#define SET_LINE(NAME) od->NAME = (sauLine*) ptrs[i++];
+	OD_LINE_ITEMS(SET_LINE)
+#undef SET_LINE
+#define SET_IDARR(NAME, IS_MOD, ...) \
+	SAU_IF(IS_MOD, od->NAME##s = ptrs[i++];, )
+	SAU_POP__ITEMS(SET_IDARR)
+#undef SET_IDARR
+	if (mask & OD_F_PARAMS) src = get_varint(src, &od->params);
+	if (mask & OD_F_TIME) {
+		src = get_varint(src, &od->time.v_ms);
+		od->time.flags = *src++;
+	}
+	if (mask & OD_F_PHASE) {
+		memcpy(&od->phase, src, sizeof(od->phase));
+		src += sizeof(od->phase);
+	}
+	if (mask & OD_F_SEED) {
+		memcpy(&od->seed, src, sizeof(od->seed));
+		src += sizeof(od->seed);
+	}
+	if (mask & OD_F_MODE) {
+		memcpy(&od->mode, src, sizeof(od->mode));
+		src += sizeof(od->mode);
+	}
+	return src;
+}
+
+/*
+ * Program image format.
+ *
+ * A program and everything it points to, written into one block
+ * of memory, which can be saved to a file and loaded as a whole.
+ * The layout, in order:
+ *  - the image head,
+ *  - the key data given when saving, compared when loading,
+ *  - the program and its data, pointers stored as image offsets,
+ *  - the relocation table, listing the offsets of all pointers.
+ *
+ * Loading turns each pointer listed back into an address. Images
+ * are only for use with the same build, and the head records the
+ * version and data layout to check that.
+ */
+
+#define IMAGE_MAGIC "SAUPRG\r\n"
+#define IMAGE_ALIGN 8 // enough for all program data types
+#define IMAGE_FORMAT 2 // revision of image contents, for layout value
+
+typedef struct ImageHead {
+	char magic[8];
+	uint32_t layout;
+	uint32_t reloc_count;
+	uint64_t len;
+	uint64_t key_len;
+	uint64_t prg_pos;
+	uint64_t reloc_pos;
+	uint64_t checksum; // of all data after the head
+} ImageHead;
+
+/*
+ * Hash bytes FNV-1a style, but a 64-bit word at a time,
+ * continuing from \p hash.
+ */
+static uint64_t hash_bytes(uint64_t hash,
+		const void *restrict data, size_t len) {
+	const uint8_t *p = data;
+	size_t i = 0;
+	for (; i + 8 <= len; i += 8) {
+		uint64_t w;
+		memcpy(&w, &p[i], 8);
+		hash ^= w;
+		hash *= UINT64_C(0x100000001b3);
+	}
+	for (; i < len; ++i) {
+		hash ^= p[i];
+		hash *= UINT64_C(0x100000001b3);
+	}
+	return hash;
+}
+
+#define HASH_INIT UINT64_C(0xcbf29ce484222325)
+
+/*
+ * Get value identifying version and data layout of program images,
+ * differing if any type or version change makes an image unusable.
+ */
+static uint32_t image_layout(void) {
+	static const char version[] = SAU_VERSION_STR;
+	const size_t sizes[] = {
+		IMAGE_FORMAT, sizeof(void*), sizeof(size_t), sizeof(ImageHead),
+		sizeof(sauProgram), sizeof(sauProgramEvent),
+		sizeof(sauProgramOpRef), sizeof(sauProgramOpData),
+		sizeof(sauProgramIDArr), sizeof(sauLine), sizeof(sauLineSeg),
+	};
+	uint64_t hash = hash_bytes(HASH_INIT, version, sizeof(version));
+	hash = hash_bytes(hash, sizes, sizeof(sizes));
+	return (uint32_t) (hash ^ (hash >> 32));
+}
+
+sauArrType(ImagePosArr, size_t, _)
+
+/*
+ * State used when writing an image.
+ */
+typedef struct ImageWriter {
+	sauByteArr data;
+	ImagePosArr relocs;
+} ImageWriter;
+
+/*
+ * Append \p len bytes copied from \p src, aligned for any
+ * program data type.
+ *
+ * \return image position, or 0 on allocation failure
+ */
+static size_t ImageWriter_put(ImageWriter *restrict o,
+		const void *restrict src, size_t len) {
+	size_t pos = (o->data.count + (IMAGE_ALIGN - 1)) & ~(IMAGE_ALIGN - 1);
+	if (!sauByteArr_upsize(&o->data, pos + len))
+		return 0;
+	memset(&o->data.a[o->data.count], 0, pos - o->data.count);
+	if (len > 0) memcpy(&o->data.a[pos], src, len);
+	o->data.count = pos + len;
+	return pos;
+}
+
+/*
+ * Append \p len bytes copied from \p src, and make the pointer
+ * at image position \p ptr_pos refer to the copy.
+ *
+ * \return image position of copy, or 0 on allocation failure
+ */
+static size_t ImageWriter_put_ref(ImageWriter *restrict o, size_t ptr_pos,
+		const void *restrict src, size_t len) {
+	size_t pos = ImageWriter_put(o, src, len);
+	if (!pos || !_ImagePosArr_push(&o->relocs, &ptr_pos))
+		return 0;
+	uintptr_t ref = pos;
+	memcpy(&o->data.a[ptr_pos], &ref, sizeof(ref));
+	return pos;
+}
+
+#define ImageWriter_PUT_REF(o, type, base_pos, field, src, len) \
+	ImageWriter_put_ref((o), (base_pos) + offsetof(type, field), \
+			(src), (len))
+
+/*
+ * Append copy of line with segments, referred to from \p ptr_pos.
+ * NULL pointers are left as is.
+ *
+ * \return true, or false on allocation failure
+ */
+static bool ImageWriter_put_line(ImageWriter *restrict o, size_t ptr_pos,
+		const sauLine *restrict line) {
+	if (!line)
+		return true;
+	size_t pos = ImageWriter_put_ref(o, ptr_pos, line, sizeof(*line));
+	if (!pos)
+		return false;
+	if (line->segs && !ImageWriter_PUT_REF(o, sauLine, pos, segs,
+				line->segs, sizeof(*line->segs) * line->seg_count))
+		return false;
+	return true;
+}
+
+/*
+ * Append copy of encoded operator data with all data pointed to,
+ * referred to from \p ptr_pos.
+ *
+ * \return true, or false on allocation failure
+ */
+static bool ImageWriter_put_op_data(ImageWriter *restrict o, size_t ptr_pos,
+		const uint8_t *restrict data, uint32_t size, uint32_t count) {
+	size_t pos = ImageWriter_put_ref(o, ptr_pos, data, size);
+	if (!pos)
+		return false;
+	const uint8_t *src = data;
+	for (uint32_t i = 0; i < count; ++i) {
+		sauProgramOpData od;
+		const void *ptrs[OD_PTRS];
+		uint32_t mask;
+		size_t ref_pos = pos + (decode_od_head(&od, src, &mask) - data);
+		src = sauProgramOpData_decode(&od, src);
+		get_od_ptrs(&od, ptrs);
+		for (int j = 0; j < OD_PTRS; ++j) {
+			if (!ptrs[j]) continue;
+			if (j < OD_LINES) {
+				if (!ImageWriter_put_line(o, ref_pos, ptrs[j]))
+					return false;
+			} else {
+				const sauProgramIDArr *idarr = ptrs[j];
+				if (!ImageWriter_put_ref(o, ref_pos, idarr,
+						sizeof(sauProgramIDArr) +
+						sizeof(uint32_t) * idarr->count))
+					return false;
+			}
+			ref_pos += sizeof(ptrs[j]);
+		}
+	}
+	return true;
+}
+
+/*
+ * Write image of program, adding all data the program points to.
+ *
+ * \return true, or false on allocation failure
+ */
+static bool ImageWriter_put_program(ImageWriter *restrict o,
+		const sauProgram *restrict prg,
+		const void *restrict key, size_t key_len) {
+	ImageHead head = {.magic = IMAGE_MAGIC};
+	sauProgram prg_copy = *prg;
+	if (!sauByteArr_upsize(&o->data, sizeof(head)))
+		return false;
+	o->data.count = sizeof(head); // filled in last
+	if (key_len > 0 && !ImageWriter_put(o, key, key_len))
+		return false;
+	prg_copy.mp = NULL;
+	prg_copy.parse = NULL;
+	prg_copy.image = NULL;
+	prg_copy.image_len = 0;
+	size_t prg_pos = ImageWriter_put(o, &prg_copy, sizeof(prg_copy));
+	if (!prg_pos)
+		return false;
+	if (prg->name && !ImageWriter_PUT_REF(o, sauProgram, prg_pos, name,
+				prg->name, strlen(prg->name) + 1))
+		return false;
+	size_t ev_pos = 0;
+	if (prg->events && !(ev_pos = ImageWriter_PUT_REF(o, sauProgram,
+					prg_pos, events, prg->events,
+					sizeof(*prg->events) * prg->ev_count)))
+		return false;
+	if (ev_pos) for (size_t i = 0; i < prg->ev_count; ++i) {
+		const sauProgramEvent *ev = &prg->events[i];
+		size_t pos = ev_pos + sizeof(*ev) * i;
+		if (ev->op_list && !ImageWriter_PUT_REF(o, sauProgramEvent,
+					pos, op_list, ev->op_list,
+					sizeof(*ev->op_list) * ev->op_count))
+			return false;
+		if (ev->op_data && !ImageWriter_put_op_data(o,
+					pos + offsetof(sauProgramEvent, op_data),
+					ev->op_data, ev->op_data_size,
+					ev->op_data_count))
+			return false;
+	}
+	size_t reloc_len = sizeof(size_t) * o->relocs.count;
+	size_t reloc_pos = (reloc_len > 0) ?
+		ImageWriter_put(o, o->relocs.a, reloc_len) :
+		o->data.count;
+	if (!reloc_pos)
+		return false;
+	head.layout = image_layout();
+	head.reloc_count = o->relocs.count;
+	head.len = o->data.count;
+	head.key_len = key_len;
+	head.prg_pos = prg_pos;
+	head.reloc_pos = reloc_pos;
+	head.checksum = hash_bytes(HASH_INIT, &o->data.a[sizeof(head)],
+			o->data.count - sizeof(head));
+	memcpy(o->data.a, &head, sizeof(head));
+	return true;
+}
+
+/**
+ * Save program as an image file, which sau_load_Program() can load
+ * for use in place of rebuilding the program. The data in \p key,
+ * if any, is saved with it, and must match when loading.
+ *
+ * The file is first written under a temporary name, then renamed.
+ *
+ * \return true, or false on error
+ */
+bool sau_save_Program(const sauProgram *restrict o, const char *restrict path,
+		const void *restrict key, size_t key_len) {
+	ImageWriter iw = {0};
+	char *tmp_path = NULL;
+	FILE *f = NULL;
+	bool ok = false;
+	if (!ImageWriter_put_program(&iw, o, key, key_len)) {
+		sau_error("program", "memory allocation failure");
+		goto DONE;
+	}
+	size_t path_len = strlen(path);
+	if (!(tmp_path = malloc(path_len + sizeof(".tmp"))))
+		goto DONE;
+	memcpy(tmp_path, path, path_len);
+	memcpy(&tmp_path[path_len], ".tmp", sizeof(".tmp"));
+	if (!(f = fopen(tmp_path, "wb")))
+		goto DONE;
+	ok = (fwrite(iw.data.a, iw.data.count, 1, f) == 1);
+	if (fclose(f) != 0) ok = false;
+	if (ok && rename(tmp_path, path) != 0) ok = false;
+	if (!ok) remove(tmp_path);
+DONE:
+	free(tmp_path);
+	sauByteArr_clear(&iw.data);
+	_ImagePosArr_clear(&iw.relocs);
+	return ok;
+}
+
+#if SAU_PROGRAM_MMAP
+/*
+ * Map file into memory, privately and with writes allowed.
+ */
+static void *map_image(const char *restrict path, size_t *restrict lenp) {
+	struct stat st;
+	void *mem = NULL;
+	int fd = open(path, O_RDONLY);
+	if (fd < 0)
+		return NULL;
+	if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) &&
+	    st.st_size >= (off_t) sizeof(ImageHead) &&
+	    (uintmax_t) st.st_size <= SIZE_MAX) {
+		mem = mmap(NULL, st.st_size, PROT_READ | PROT_WRITE,
+				MAP_PRIVATE, fd, 0);
+		if (mem == MAP_FAILED)
+			mem = NULL;
+		else
+			*lenp = st.st_size;
+	}
+	close(fd);
+	return mem;
+}
+
+static void unmap_image(void *restrict mem, size_t len) {
+	munmap(mem, len);
+}
+#else
+/*
+ * Read whole file into allocated memory.
+ */
+static void *map_image(const char *restrict path, size_t *restrict lenp) {
+	sauByteArr data = {0};
+	FILE *f = fopen(path, "rb");
+	if (!f)
+		return NULL;
+	for (;;) {
+		if (!sauByteArr_upsize(&data, data.count + BUFSIZ))
+			goto ERROR;
+		size_t len = fread(&data.a[data.count], 1,
+				data.asize - data.count, f);
+		data.count += len;
+		if (len == 0) break;
+	}
+	if (ferror(f) || data.count < sizeof(ImageHead)) goto ERROR;
+	fclose(f);
+	*lenp = data.count;
+	return data.a;
+ERROR:
+	fclose(f);
+	sauByteArr_clear(&data);
+	return NULL;
+}
+
+static void unmap_image(void *restrict mem, size_t len) {
+	(void)len;
+	free(mem);
+}
+#endif
+
+/*
+ * Check image head and contents, and turn the image offsets
+ * stored for pointers into addresses.
+ *
+ * \return true, or false if not a valid image for \p key
+ */
+static bool relocate_image(uint8_t *restrict mem, size_t len,
+		const void *restrict key, size_t key_len) {
+	ImageHead head;
+	memcpy(&head, mem, sizeof(head));
+	if (memcmp(head.magic, IMAGE_MAGIC, sizeof(head.magic)) != 0 ||
+	    head.layout != image_layout() ||
+	    head.len != len ||
+	    head.key_len != key_len ||
+	    key_len > len - sizeof(head) ||
+	    (key_len > 0 && memcmp(&mem[sizeof(head)], key, key_len) != 0) ||
+	    head.prg_pos > len - sizeof(sauProgram) ||
+	    (head.prg_pos & (IMAGE_ALIGN - 1)) != 0 ||
+	    head.reloc_pos > len ||
+	    (head.reloc_pos & (IMAGE_ALIGN - 1)) != 0 ||
+	    head.reloc_count > (len - head.reloc_pos) / sizeof(size_t))
+		return false;
+	if (head.checksum != hash_bytes(HASH_INIT, &mem[sizeof(head)],
+				len - sizeof(head)))
+		return false;
+	const size_t *relocs = (const size_t*) &mem[head.reloc_pos];
+	for (size_t i = 0; i < head.reloc_count; ++i) {
+		size_t ptr_pos = relocs[i];
+		uintptr_t ref;
+		if (ptr_pos > len - sizeof(ref))
+			return false;
+		memcpy(&ref, &mem[ptr_pos], sizeof(ref));
+		if (ref >= len)
+			return false;
+		ref += (uintptr_t) mem;
+		memcpy(&mem[ptr_pos], &ref, sizeof(ref));
+	}
+	return true;
+}
+
+/**
+ * Load program from an image file written by sau_save_Program().
+ * The data in \p key, if any, must match that given when saving.
+ *
+ * Where supported, the file is memory-mapped, and its data is used
+ * directly after relocation. Use sau_discard_Program() when done.
+ *
+ * \return instance, or NULL if missing, mismatched or invalid
+ */
+sauProgram *sau_load_Program(const char *restrict path,
+		const void *restrict key, size_t key_len) {
+	size_t len = 0;
+	uint8_t *mem = map_image(path, &len);
+	if (!mem)
+		return NULL;
+	if (!relocate_image(mem, len, key, key_len)) {
+		unmap_image(mem, len);
+		return NULL;
+	}
+	ImageHead head;
+	memcpy(&head, mem, sizeof(head));
+	sauProgram *o = (sauProgram*) &mem[head.prg_pos];
+	o->image = mem;
+	o->image_len = len;
+	return o;
+}
+
+/**
+ * Destroy instance, built or loaded.
+ */
+void sau_discard_Program(sauProgram *restrict o) {
+	if (!o)
+		return;
+	if (o->image != NULL) {
+		unmap_image(o->image, o->image_len);
+		return;
+	}
+	sau_destroy_Mempool(o->mp);
+}
@@ -14,6 +14,8 @@
 #pragma once
 #include "line.h"
 #include "wave.h"
+#include "mempool.h"
+#include "symtab.h"
 
 /*
  * Program types and definitions.
@@ -95,7 +97,8 @@ enum {
 	SAU_POPP_MODE = 1<<1, // type-specific data
 	SAU_POPP_PHASE = 1<<2,
 	SAU_POPP_SEED = 1<<3,
-	SAU_POP_PARAMS = (1<<4) - 1,
+	SAU_POPP_INIT = 1<<4, // new operator, maybe reusing an ID
+	SAU_POP_PARAMS = (1<<5) - 1,
 };
 
 /* Macro used to declare and define noise type sets of items. */
@@ -230,14 +233,23 @@ typedef struct sauProgramOpData {
 	SAU_POP__ITEMS(SAU_POP__X_IDARR_PTR)
 } sauProgramOpData;
 
+/** Maximum size of operator data in the compact encoding. */
+#define SAU_POPDATA_ENC_MAX (sizeof(sauProgramOpData) + 16)
+
+uint8_t *sauProgramOpData_encode(uint8_t *restrict dst,
+		const sauProgramOpData *restrict od);
+const uint8_t *sauProgramOpData_decode(sauProgramOpData *restrict od,
+		const uint8_t *restrict src);
+
 typedef struct sauProgramEvent {
 	uint32_t wait_ms;
 	uint16_t vo_id;
 	uint32_t carr_op_id;
 	uint32_t op_count;
 	uint32_t op_data_count;
+	uint32_t op_data_size; // bytes of encoded operator data
 	const sauProgramOpRef *op_list; // used for printout
-	const sauProgramOpData *op_data;
+	const uint8_t *op_data; // encoded; see sauProgramOpData_decode()
 } sauProgramEvent;
 
 /**
@@ -245,6 +257,7 @@ typedef struct sauProgramEvent {
  */
 enum {
 	SAU_PMODE_AMP_DIV_VOICES = 1<<0,
+	SAU_PMODE_STREAM         = 1<<1, // part of program, more may follow
 };
 
 /**
@@ -260,13 +273,39 @@ typedef struct sauProgram {
 	uint32_t duration_ms;
 	float ampmult;
 	const char *name;
+	bool time_used; // built using the current time, varies between runs
 	struct sauMempool *mp; // holds memory for the specific program
 	struct sauScript *parse; // parser output used to build program
+	size_t script_mem; // bytes requested for parse data, in its own pool
+	sauMempoolStats parse_mem; // parser's node pool, freed after
+	sauSymtabStats sym_stats; // parser's symbol table use
+	void *image; // if loaded, holds all program data instead of mp
+	size_t image_len;
 } sauProgram;
 
+/**
+ * Function receiving a program in parts, each holding the events
+ * newly built, while the other values are those reached so far.
+ * The last part lacks SAU_PMODE_STREAM, and may have no events.
+ * The data is only valid until the function returns, except that
+ * data referenced by events remains until the last part returns.
+ *
+ * \return true to continue, or false to stop
+ */
+typedef bool (*sauProgramStream_f)(void *restrict data,
+		const sauProgram *restrict part);
+
 struct sauScript;
 struct sauScriptArg;
+bool sau_global_init_Parser(void);
 sauProgram* sau_build_Program(const struct sauScriptArg *restrict arg) sauMalloclike;
+bool sau_stream_Program(const struct sauScriptArg *restrict arg,
+		sauProgramStream_f stream_f, void *restrict data);
 void sau_discard_Program(sauProgram *restrict o);
 
+bool sau_save_Program(const sauProgram *restrict o, const char *restrict path,
+		const void *restrict key, size_t key_len);
+sauProgram* sau_load_Program(const char *restrict path,
+		const void *restrict key, size_t key_len) sauMalloclike;
+
 void sauProgram_print_info(const sauProgram *restrict o);
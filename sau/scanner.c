@@ -75,14 +75,16 @@ void sau_destroy_Scanner(sauScanner *restrict o) {
  *
  * Wrapper around sauFile functions. \p script may be
  * either a file path or a string, depending on \p is_path.
+ * A string is named \p name in messages, or "<string>" if NULL.
  *
  * \return true on success
  */
 bool sauScanner_open(sauScanner *restrict o,
-		const char *restrict script, bool is_path) {
+		const char *restrict script, bool is_path,
+		const char *restrict name) {
 	if (!is_path) {
-		sauFile_stropenrb(o->f, "<string>", script);
-	} else if (!sauFile_fopenrb(o->f, script)) {
+		sauFile_stropenrb(o->f, name ? name : "<string>", script);
+	} else if (!sauFile_mapopenrb(o->f, script)) {
 		sau_error(NULL,
 "couldn't open script file \"%s\" for reading", script);
 		return false;
@@ -252,6 +254,7 @@ uint8_t sauScanner_filter_blockcomment(sauScanner *restrict o,
 	int32_t line_num = o->sf.line_num;
 	int32_t char_num = o->sf.char_num;
 	for (;;) {
+		char_num += sauFile_skipuntil(f, check_c);
 		uint8_t c = sauFile_GETC(f);
 		++char_num;
 		if (c == '\n') {
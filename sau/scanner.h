@@ -151,7 +151,8 @@ sauScanner *sau_create_Scanner(sauSymtab *restrict symtab) sauMalloclike;
 void sau_destroy_Scanner(sauScanner *restrict o);
 
 bool sauScanner_open(sauScanner *restrict o,
-		const char *restrict script, bool is_path);
+		const char *restrict script, bool is_path,
+		const char *restrict name);
 void sauScanner_close(sauScanner *restrict o);
 
 /**
@@ -31,8 +31,12 @@ typedef struct sauScriptObjInfo {
 	uint32_t root_op_obj; // root op for op
 	uint32_t parent_op_obj; // parent op for any object
 	uint32_t seed; // TODO: divide containing node type
+	uint32_t ref_count; // references left to convert, for ID reuse
 } sauScriptObjInfo;
 
+/** Reference count for object which may be referenced at any later time. */
+#define SAU_SOBJ_REFS_KEEP UINT32_MAX
+
 /** Reference to script data object, common data for all subtypes. */
 typedef struct sauScriptObjRef {
 	uint32_t obj_id; // shared by all references to an object
@@ -134,8 +138,10 @@ typedef struct sauScriptPredef {
 /** Specifies a script to parse (and possibly process further). */
 typedef struct sauScriptArg {
 	const char *str;
+	const char *name; // for a string, name to use instead of "<string>"
 	bool is_path : 1;
 	bool no_time : 1;
+	bool keep_parse : 1; // keep parse data (symbols, objects) with program
 	sauScriptPredef *predef;
 	size_t predef_count;
 } sauScriptArg;
@@ -161,12 +167,12 @@ typedef struct sauScriptOptions {
 } sauScriptOptions;
 
 /**
- * Type returned after processing a file. The data is divided into
- * two mempools, one specific to the parse and one shared with any
- * later program data (sauProgram), if built from the same parse.
+ * Type returned after processing a file. The data is held in a mempool
+ * specific to the parse, apart from any program data (sauProgram) built
+ * from the same parse. Event nodes are dropped after conversion, so the
+ * parse keeps only what outlasts them.
  */
 typedef struct sauScript {
-	sauScriptEvData *events;
 	sauScriptObjInfo *objects; // currently also op info array
 	sauScriptOptions sopt;
 	uint32_t object_count;
@@ -17,17 +17,11 @@
 
 #define STRTAB_ALLOC_INITIAL 1024
 
-#ifndef SAU_SYMTAB_STATS
 /*
- * Print symbol table statistics for testing?
+ * Open addressing hash table, with linear probing. No nodes are
+ * ever removed, so an empty slot ends a search. The hash of each
+ * key is kept in its node, so the table is cheap to resize.
  */
-# define SAU_SYMTAB_STATS 0
-#endif
-#if SAU_SYMTAB_STATS
-static size_t collision_count = 0;
-#include <stdio.h>
-#endif
-
 typedef struct StrTab {
 	sauSymstr **sstra;
 	size_t count;
@@ -39,25 +33,30 @@ static inline void fini_StrTab(StrTab *restrict o) {
 }
 
 /*
- * Return the hash of the given string \p key of lenght \p len.
+ * Return the hash of the given string \p key of length \p len.
+ *
+ * Uses FNV-1a over 64-bit words (and a last partial word),
+ * followed by a final mix to spread changes to the low bits
+ * used for indexing.
  *
  * \return hash
  */
-static size_t StrTab_hash_key(StrTab *restrict o,
-		const uint8_t *restrict key, size_t len) {
-	size_t i;
-	size_t hash;
-	/*
-	 * Calculate DJB2 hash,
-	 * varied by adding len.
-	 */
-	hash = 5381 + (len * 33);
-	for (i = 0; i < len; ++i) {
-		size_t c = key[i];
-		hash = ((hash << 5) + hash) ^ c;
+static uint32_t StrTab_hash_key(const uint8_t *restrict key, size_t len) {
+	uint64_t hash = UINT64_C(14695981039346656037) ^ len;
+	uint64_t w;
+	for (; len >= 8; key += 8, len -= 8) {
+		memcpy(&w, key, 8);
+		hash = (hash ^ w) * UINT64_C(1099511628211);
+	}
+	if (len > 0) {
+		w = 0;
+		memcpy(&w, key, len);
+		hash = (hash ^ w) * UINT64_C(1099511628211);
 	}
-	hash &= (o->alloc - 1);
-	return hash;
+	hash ^= hash >> 32;
+	hash *= UINT64_C(0xd6e8feb86659fd93);
+	hash ^= hash >> 32;
+	return (uint32_t) hash;
 }
 
 /*
@@ -68,7 +67,6 @@ static size_t StrTab_hash_key(StrTab *restrict o,
 static bool StrTab_upsize(StrTab *restrict o) {
 	sauSymstr **sstra, **old_sstra = o->sstra;
 	size_t alloc, old_alloc = o->alloc;
-	size_t i;
 	alloc = (old_alloc > 0) ?
 		(old_alloc << 1) :
 		STRTAB_ALLOC_INITIAL;
@@ -79,65 +77,72 @@ static bool StrTab_upsize(StrTab *restrict o) {
 	o->sstra = sstra;
 
 	/*
-	 * Rehash entries
+	 * Reinsert entries, using the stored hashes.
 	 */
-	for (i = 0; i < old_alloc; ++i) {
+	for (size_t i = 0; i < old_alloc; ++i) {
 		sauSymstr *node = old_sstra[i];
-		while (node != NULL) {
-			sauSymstr *prev_node;
-			size_t hash;
-			hash = StrTab_hash_key(o, node->key, node->key_len);
-			/*
-			 * Before adding the entry to the new table, set
-			 * node->prev to the previous (if any) node with
-			 * the same hash in the new table. Done repeatedly,
-			 * the links are rebuilt, though not necessarily in
-			 * the same order.
-			 */
-			prev_node = node->prev;
-			node->prev = o->sstra[hash];
-			o->sstra[hash] = node;
-			node = prev_node;
-		}
+		if (!node)
+			continue;
+		size_t j = node->hash & (alloc - 1);
+		while (sstra[j] != NULL)
+			j = (j + 1) & (alloc - 1);
+		sstra[j] = node;
 	}
 	free(old_sstra);
 	return true;
 }
 
 /*
- * Get unique node for key in hash table, adding it if missing.
- * If allocated, \p extra is added to the size of the node; use
- * 1 to add a NULL-byte for a string key.
+ * Look for node for key with \p hash in hash table, without changing
+ * the table. The probe counts are added to \p stats.
+ *
+ * \return sauSymstr, or NULL if missing
+ */
+static sauSymstr *StrTab_find_node(const StrTab *restrict o,
+		sauSymtabStats *restrict stats, uint32_t hash,
+		const void *restrict key, size_t len) {
+	if (o->alloc == 0)
+		return NULL;
+	size_t i = hash & (o->alloc - 1);
+	size_t probes = 1;
+	sauSymstr *sstr;
+	++stats->lookups;
+	while ((sstr = o->sstra[i]) != NULL) {
+		if (sstr->hash == hash && sstr->key_len == len &&
+		    !memcmp(sstr->key, key, len)) break;
+		i = (i + 1) & (o->alloc - 1);
+		++probes;
+	}
+	stats->probes += probes;
+	if (probes > stats->max_probes) stats->max_probes = probes;
+	return sstr;
+}
+
+/*
+ * Add node for key with \p hash to hash table, which must not already
+ * hold it. \p extra is added to the size of the node; use 1 to add a
+ * NULL-byte for a string key.
  *
  * Initializes the hash table if empty.
  *
  * \return sauSymstr, or NULL on allocation failure
  */
-static sauSymstr *StrTab_unique_node(StrTab *restrict o,
-		sauMempool *restrict memp,
+static sauSymstr *StrTab_add_node(StrTab *restrict o,
+		sauMempool *restrict memp, uint32_t hash,
 		const void *restrict key, size_t len, size_t extra) {
-	if (!key || len == 0)
-		return NULL;
 	if (o->count == (o->alloc / 2)) {
 		if (!StrTab_upsize(o))
 			return NULL;
 	}
 
-	size_t hash = StrTab_hash_key(o, key, len);
-	sauSymstr *sstr = o->sstra[hash];
-	while (sstr != NULL) {
-		if (sstr->key_len == len &&
-			!memcmp(sstr->key, key, len)) return sstr;
-		sstr = sstr->prev;
-#if SAU_SYMTAB_STATS
-		++collision_count;
-#endif
-	}
-	sstr = sau_mpalloc(memp, sizeof(sauSymstr) + (len + extra));
+	sauSymstr *sstr = sau_mpalloc(memp, sizeof(sauSymstr) + (len + extra));
 	if (!sstr)
 		return NULL;
-	sstr->prev = o->sstra[hash];
-	o->sstra[hash] = sstr;
+	size_t i = hash & (o->alloc - 1);
+	while (o->sstra[i] != NULL)
+		i = (i + 1) & (o->alloc - 1);
+	o->sstra[i] = sstr;
+	sstr->hash = hash;
 	sstr->key_len = len;
 	memcpy(sstr->key, key, len);
 	++o->count;
@@ -146,40 +151,87 @@ static sauSymstr *StrTab_unique_node(StrTab *restrict o,
 
 struct sauSymtab {
 	sauMempool *memp;
+	const sauSymtab *base;
 	StrTab strt;
+	sauSymtabStats stats;
 };
 
 static void fini_Symtab(sauSymtab *restrict o) {
-#if SAU_SYMTAB_STATS
-	fprintf(stderr, "collision count: %zd\n", collision_count);
-#endif
 	fini_StrTab(&o->strt);
 }
 
 /**
  * Create instance. Requires \p mempool to be a valid instance.
  *
+ * If \p base is not NULL, the new instance is layered over it,
+ * and will look up strings in it which are not yet held. The
+ * \p base instance is only read, never changed, and it must
+ * outlive the new instance. It can be shared by any number of
+ * instances, including in different threads.
+ *
  * \return instance, or NULL on allocation failure
  */
-sauSymtab *sau_create_Symtab(sauMempool *restrict mempool) {
+sauSymtab *sau_create_Symtab(sauMempool *restrict mempool,
+		const sauSymtab *restrict base) {
 	if (!mempool)
 		return NULL;
 	sauSymtab *o = sau_mpalloc(mempool, sizeof(sauSymtab));
 	if (!sau_mpregdtor(mempool, (sauDtor_f) fini_Symtab, o))
 		return NULL;
 	o->memp = mempool;
+	o->base = base;
 	return o;
 }
 
+/*
+ * Copy the items of \p base_sstr over to \p sstr, in the same order.
+ *
+ * \return true, or false on allocation failure
+ */
+static bool copy_items(sauSymtab *restrict o,
+		sauSymstr *restrict sstr, const sauSymstr *restrict base_sstr) {
+	sauSymitem **next = &sstr->item;
+	for (const sauSymitem *base_item = base_sstr->item; base_item;
+			base_item = base_item->prev) {
+		sauSymitem *item = sau_mpmemdup(o->memp,
+				base_item, sizeof(sauSymitem));
+		if (!item)
+			return false;
+		item->sstr = sstr;
+		item->prev = NULL;
+		*next = item;
+		next = &item->prev;
+	}
+	return true;
+}
+
 /**
  * Get the unique node held for \p str in the symbol table,
  * adding \p str to the string pool unless already present.
  *
+ * If missing but found in the base instance, the node added
+ * gets copies of the items for the string in the base, which
+ * can then be changed without affecting the base.
+ *
  * \return unique node for \p str, or NULL on allocation failure
  */
 sauSymstr *sauSymtab_get_symstr(sauSymtab *restrict o,
 		const void *restrict str, size_t len) {
-	return StrTab_unique_node(&o->strt, o->memp, str, len, 1);
+	if (!str || len == 0)
+		return NULL;
+	uint32_t hash = StrTab_hash_key(str, len);
+	sauSymstr *sstr = StrTab_find_node(&o->strt, &o->stats,
+			hash, str, len);
+	if (sstr != NULL)
+		return sstr;
+	const sauSymstr *base_sstr = o->base ?
+		StrTab_find_node(&o->base->strt, &o->stats, hash, str, len) :
+		NULL;
+	sstr = StrTab_add_node(&o->strt, o->memp, hash, str, len, 1);
+	if (sstr != NULL && base_sstr != NULL &&
+	    !copy_items(o, sstr, base_sstr))
+		return NULL;
+	return sstr;
 }
 
 /**
@@ -239,3 +291,15 @@ bool sauSymtab_add_stra(sauSymtab *restrict o,
 	}
 	return true;
 }
+
+/**
+ * Get statistics for the string hash table, as counted since creation.
+ * The probe counts include lookups in any base instance, counted for
+ * this instance.
+ */
+void sauSymtab_get_stats(const sauSymtab *restrict o,
+		sauSymtabStats *restrict stats) {
+	*stats = o->stats;
+	stats->count = o->strt.count;
+	stats->alloc = o->strt.alloc;
+}
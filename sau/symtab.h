@@ -18,8 +18,8 @@
  * Node stored for each unique string associated with the symbol table.
  */
 typedef struct sauSymstr {
-	struct sauSymstr *prev;
 	struct sauSymitem *item; // the last item with this string
+	uint32_t hash;
 	uint32_t key_len;
 	uint8_t key[];
 } sauSymstr;
@@ -50,7 +50,8 @@ typedef struct sauSymitem {
 struct sauSymtab;
 typedef struct sauSymtab sauSymtab;
 
-sauSymtab *sau_create_Symtab(sauMempool *restrict mempool) sauMalloclike;
+sauSymtab *sau_create_Symtab(sauMempool *restrict mempool,
+		const sauSymtab *restrict base) sauMalloclike;
 
 sauSymstr *sauSymtab_get_symstr(sauSymtab *restrict o,
 		const void *restrict str, size_t len);
@@ -63,3 +64,17 @@ sauSymitem *sauSymtab_find_item(sauSymtab *restrict o,
 bool sauSymtab_add_stra(sauSymtab *restrict o,
 		const char *const*restrict stra, size_t n,
 		uint32_t sym_type, uint32_t id_from);
+
+/**
+ * Symbol table statistics.
+ */
+typedef struct sauSymtabStats {
+	size_t count; // number of unique strings held
+	size_t alloc; // number of hash table slots
+	size_t lookups; // number of string lookups
+	size_t probes; // total slots probed in lookups
+	size_t max_probes; // most slots probed in a lookup
+} sauSymtabStats;
+
+void sauSymtab_get_stats(const sauSymtab *restrict o,
+		sauSymtabStats *restrict stats);
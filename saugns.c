@@ -15,6 +15,19 @@
  * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
  */
 
+#ifndef USE_PRG_CACHE
+/*
+ * Cache built programs in a per-user directory, where supported?
+ */
+# if defined(__unix__) || (defined(__APPLE__) && defined(__MACH__))
+#  define USE_PRG_CACHE 1
+# else
+#  define USE_PRG_CACHE 0
+# endif
+#endif
+#if USE_PRG_CACHE
+# define _POSIX_C_SOURCE 200809L
+#endif
 #include "saugns.h"
 #include <sau/script.h>
 #include <sau/scanner.h> // character tests
@@ -27,7 +40,13 @@
 #include <errno.h>
 #include <stdlib.h>
 #include <string.h>
+#if USE_PRG_CACHE
+# include <sys/stat.h>
+# include <dirent.h>
+# include <fcntl.h>
+#endif
 #define NAME CLINAME_STR
+#define CACHE_MAX 100 /* most programs kept in the cache, newest used */
 #if SGS_ADD_TESTOPT
 # define TESTOPT "?:"
 int SGS_testopt = 0;
@@ -50,6 +69,9 @@ enum {
 	OPT_EVAL_STRING   = 1<<8,
 	OPT_DETERMINISTIC = 1<<9,
 	OPT_PRINT_VERBOSE = 1<<10,
+	OPT_TUNE_BLOCK    = 1<<11,
+	OPT_USE_CACHE     = 1<<12,
+	OPT_STREAM        = 1<<13,
 };
 
 /*
@@ -80,7 +102,9 @@ sauArrType(sauProgramArr, sauProgram*, )
 static void print_usage(bool h_arg, const char *restrict h_type) {
 	fputs(
 "Usage: "NAME" [-a | -m] [-r <srate>] [--mono] [-o <file>] [--stdout]\n"
-"              [-d] [-p] [variable=value] [-e] <script>...\n"
+"              [-b <len>] [-C] [-d] [-p] [variable=value] [-e] <script>...\n"
+"       "NAME" -s [-a | -m] [-r <srate>] [--mono] [-o <file>] [--stdout]\n"
+"              [-b <len>] [-d] [variable=value] [-e] <script>...\n"
 "       "NAME" -c [-d] [-p] [variable=value] [-e] <script>...\n",
 		h_arg ? stdout : stderr);
 	if (!h_type)
@@ -95,9 +119,17 @@ static void print_usage(bool h_arg, const char *restrict h_type) {
 "     \tOr for AU over stdout, \"-\". Disables system audio output by default.\n"
 "  --mono \tDownmix and output audio as mono; this applies to all outputs.\n"
 "  --stdout \tSend a raw 16-bit output to stdout, -r or default sample rate.\n"
+"  -b \tGenerator block length in samples (default "SAU_STREXP(SAU_GEN_BLOCK_LEN_DEFAULT)");\n"
+"     \tor \"auto\" to benchmark a few lengths per script and pick the fastest.\n"
+"  -s \tPart-wise; generate audio for each part of a script up to a time\n"
+"     \tseparator (|) once it's read. Not streaming: a script without any is\n"
+"     \tone part, and memory use still grows with script length, as only the\n"
+"     \tevents of parts are freed. Amplitude is set by the first part only.\n"
 "\n"
 "Other options:\n"
 "  -c \tCheck scripts only; parse, handle -p, but don't interpret unlike -m.\n"
+"  -C \tCache programs built, for unchanged scripts to reuse in later runs.\n"
+"     \tKeeps the "SAU_STREXP(CACHE_MAX)" last used in ~/.cache/"NAME"/, which may be deleted.\n"
 "  -d \tDeterministic mode; ensures unvarying script output from same input.\n"
 "  -p \tPrint info for scripts read.\n"
 "  -e \tEvaluate strings instead of files. Applies to scripts after.\n"
@@ -292,7 +324,8 @@ static bool parse_args(int argc, char **restrict argv,
 		sauScriptArgArr *restrict script_args,
 		sauScriptPredefArr *restrict predef_args,
 		const char **restrict wav_path,
-		uint32_t *restrict srate) {
+		uint32_t *restrict srate,
+		uint32_t *restrict block_len) {
 	struct Opt opt = {0};
 	sauScriptPredef predef = {0};
 	int c;
@@ -304,7 +337,7 @@ static bool parse_args(int argc, char **restrict argv,
 	opt.err = 1;
 REPARSE:
 	while ((c = getopt(argc, argv,
-	                       "Vamr:o:ecdphv"TESTOPT
+	                       "Vamr:o:b:eCcdpshv"TESTOPT
 			       "-mono-stdout", &opt)) != -1) {
 		switch (c) {
 		case '-':
@@ -340,6 +373,28 @@ REPARSE:
 			*flags |= OPT_MODE_FULL |
 				OPT_SYSAU_ENABLE;
 			break;
+		case 'b':
+			if (*flags & OPT_MODE_CHECK)
+				goto USAGE;
+			*flags |= OPT_MODE_FULL;
+			if (!strcmp(opt.arg, "auto")) {
+				if (*flags & OPT_STREAM)
+					goto USAGE;
+				*flags |= OPT_TUNE_BLOCK;
+				continue;
+			}
+			if (!get_iarg(opt.arg, &i) ||
+			    (i < SAU_GEN_BLOCK_LEN_MIN) ||
+			    (i > SAU_GEN_BLOCK_LEN_MAX)) goto USAGE;
+			*block_len = i;
+			continue;
+		case 'C':
+			if (*flags & (OPT_MODE_CHECK |
+			              OPT_STREAM))
+				goto USAGE;
+			*flags |= OPT_MODE_FULL |
+				OPT_USE_CACHE;
+			break;
 		case 'c':
 			if (*flags & OPT_MODE_FULL)
 				goto USAGE;
@@ -375,6 +430,8 @@ REPARSE:
 			*wav_path = opt.arg;
 			continue;
 		case 'p':
+			if (*flags & OPT_STREAM)
+				goto USAGE;
 			*flags |= OPT_PRINT_INFO;
 			break;
 		case 'r':
@@ -384,6 +441,15 @@ REPARSE:
 			if (!get_iarg(opt.arg, &i) || (i <= 0)) goto USAGE;
 			*srate = i;
 			continue;
+		case 's':
+			if (*flags & (OPT_MODE_CHECK |
+			              OPT_PRINT_INFO |
+			              OPT_TUNE_BLOCK |
+			              OPT_USE_CACHE))
+				goto USAGE;
+			*flags |= OPT_MODE_FULL |
+				OPT_STREAM;
+			break;
 		case 'v':
 			*flags |= OPT_PRINT_VERBOSE;
 			break;
@@ -428,6 +494,7 @@ REPARSE:
 	for (size_t i = 0; i < script_args->count; ++i) {
 		sauScriptArg *arg = &script_args->a[i];
 		arg->no_time = *flags & OPT_DETERMINISTIC;
+		arg->keep_parse = *flags & OPT_PRINT_INFO;
 		arg->predef = predef_args->a;
 		arg->predef_count = predef_args->count;
 	}
@@ -440,20 +507,238 @@ ABORT:
 	return false;
 }
 
+#if USE_PRG_CACHE
+/*
+ * Get directory for the program cache, creating it if missing.
+ * Uses $XDG_CACHE_HOME, or else $HOME/.cache, as the base path.
+ *
+ * \return true if directory path set in \p dir, false if unavailable
+ */
+static bool get_cache_dir(sauByteArr *restrict dir) {
+	const char *base = getenv("XDG_CACHE_HOME"), *sub = "/"NAME;
+	if (!base || base[0] != '/') {
+		base = getenv("HOME");
+		if (!base || base[0] != '/') return false;
+		sub = "/.cache/"NAME;
+	}
+	size_t base_len = strlen(base), sub_len = strlen(sub);
+	if (!sauByteArr_upsize(dir, base_len + sub_len + 1)) return false;
+	memcpy(dir->a, base, base_len);
+	memcpy(&dir->a[base_len], sub, sub_len + 1);
+	dir->count = base_len + sub_len;
+	for (size_t i = 1; i <= dir->count; ++i) {
+		struct stat st;
+		if (dir->a[i] != '/' && dir->a[i] != '\0') continue;
+		dir->a[i] = '\0';
+		if (mkdir((char*) dir->a, 0777) != 0 &&
+		    (stat((char*) dir->a, &st) != 0 || !S_ISDIR(st.st_mode))) {
+			sauByteArr_clear(dir);
+			return false;
+		}
+		if (i < dir->count) dir->a[i] = '/';
+	}
+	return true;
+}
+
+static bool push_bytes(sauByteArr *restrict o,
+		const void *restrict src, size_t len) {
+	if (!sauByteArr_upsize(o, o->count + len)) return false;
+	memcpy(&o->a[o->count], src, len);
+	o->count += len;
+	return true;
+}
+
+/*
+ * Read whole script file into \p text, as a NULL-terminated string
+ * which is then parsed in place of the file, so that the cache key
+ * is made from the same contents as the program.
+ *
+ * \return true, or false on error or if the file has a NULL byte
+ */
+static bool read_script_text(const char *restrict path,
+		sauByteArr *restrict text) {
+	FILE *f = fopen(path, "rb");
+	if (!f)
+		return false;
+	text->count = 0;
+	for (;;) {
+		if (!sauByteArr_upsize(text, text->count + BUFSIZ)) break;
+		size_t len = fread(&text->a[text->count], 1, BUFSIZ, f);
+		text->count += len;
+		if (len < BUFSIZ) break;
+	}
+	bool ok = !ferror(f) && feof(f) &&
+		push_bytes(text, "", 1) &&
+		strlen((char*) text->a) == --text->count;
+	fclose(f);
+	return ok;
+}
+
+/*
+ * Get cache key for script, i.e. all input affecting the program built,
+ * including the \p text to parse.
+ *
+ * \return true, or false on error
+ */
+static bool get_cache_key(const sauScriptArg *restrict arg,
+		const sauByteArr *restrict text, sauByteArr *restrict key) {
+	static const char version[] = NAME" "VERSION_STR;
+	uint8_t arg_flags = arg->is_path | (arg->no_time << 1) |
+		(arg->keep_parse << 2);
+	key->count = 0;
+	if (!push_bytes(key, version, sizeof(version)) ||
+	    !push_bytes(key, &arg_flags, 1) ||
+	    !push_bytes(key, arg->str, strlen(arg->str) + 1))
+		return false;
+	for (size_t i = 0; i < arg->predef_count; ++i) {
+		const sauScriptPredef *predef = &arg->predef[i];
+		if (!push_bytes(key, &predef->len, sizeof(predef->len)) ||
+		    !push_bytes(key, predef->key, predef->len) ||
+		    !push_bytes(key, &predef->val, sizeof(predef->val)))
+			return false;
+	}
+	return !arg->is_path || push_bytes(key, text->a, text->count);
+}
+
+/*
+ * Set \p path to the cache file path for \p key, under \p dir.
+ * The file is named after a 64-bit hash of the key, FNV-1a style
+ * but a word at a time; the whole key is compared when loading.
+ *
+ * \return true, or false on allocation failure
+ */
+static bool get_cache_path(const sauByteArr *restrict dir,
+		const sauByteArr *restrict key, sauByteArr *restrict path) {
+	uint64_t hash = UINT64_C(0xcbf29ce484222325);
+	size_t i = 0;
+	for (; i + 8 <= key->count; i += 8) {
+		uint64_t w;
+		memcpy(&w, &key->a[i], 8);
+		hash ^= w;
+		hash *= UINT64_C(0x100000001b3);
+	}
+	for (; i < key->count; ++i) {
+		hash ^= key->a[i];
+		hash *= UINT64_C(0x100000001b3);
+	}
+	size_t len = dir->count + sizeof("/0123456789abcdef.prg");
+	if (!sauByteArr_upsize(path, len)) return false;
+	path->count = snprintf((char*) path->a, len, "%s/%016llx.prg",
+			(const char*) dir->a, (unsigned long long) hash);
+	return true;
+}
+
+typedef struct CacheFile {
+	time_t mtime;
+	char name[sizeof("0123456789abcdef.prg")];
+} CacheFile;
+
+sauArrType(CacheFileArr, CacheFile, )
+
+static int cmp_cache_file(const void *restrict a, const void *restrict b) {
+	time_t a_t = ((const CacheFile*) a)->mtime;
+	time_t b_t = ((const CacheFile*) b)->mtime;
+	return (a_t > b_t) - (a_t < b_t);
+}
+
+/*
+ * Remove the least recently used program files in \p dir,
+ * beyond the CACHE_MAX most recent ones. Loading a program
+ * updates its file time, so that it counts as used.
+ */
+static void trim_cache_dir(const sauByteArr *restrict dir) {
+	CacheFileArr files = {0};
+	sauByteArr path = {0};
+	DIR *d = opendir((const char*) dir->a);
+	struct dirent *ent;
+	if (!d)
+		return;
+	while ((ent = readdir(d)) != NULL) {
+		size_t len = strlen(ent->d_name);
+		struct stat st;
+		CacheFile *file;
+		if (len != sizeof(file->name) - 1 ||
+		    strcmp(&ent->d_name[len - 4], ".prg") != 0 ||
+		    fstatat(dirfd(d), ent->d_name, &st, 0) != 0 ||
+		    !(file = CacheFileArr_add(&files)))
+			continue;
+		file->mtime = st.st_mtime;
+		memcpy(file->name, ent->d_name, len + 1);
+	}
+	if (files.count > CACHE_MAX) {
+		qsort(files.a, files.count, sizeof(CacheFile), cmp_cache_file);
+		for (size_t i = 0; i < files.count - CACHE_MAX; ++i) {
+			path.count = 0;
+			if (!push_bytes(&path, dir->a, dir->count) ||
+			    !push_bytes(&path, "/", 1) ||
+			    !push_bytes(&path, files.a[i].name,
+				    sizeof(files.a[i].name)))
+				break;
+			remove((char*) path.a);
+		}
+	}
+	closedir(d);
+	CacheFileArr_clear(&files);
+	sauByteArr_clear(&path);
+}
+#endif
+
 /*
  * Load the listed scripts and build inner programs for them,
  * adding each result (even if NULL) to the program list.
  *
+ * If \p use_cache is true, first tries to load each program
+ * from the cache, and saves programs built for later use.
+ * A script file is then read once, and parsed from memory.
+ *
  * \return number of items successfully processed
  */
 static size_t read_scripts(const sauScriptArgArr *restrict script_args,
-		sauProgramArr *restrict prg_objs) {
+		sauProgramArr *restrict prg_objs, bool use_cache) {
 	size_t built = 0;
+#if USE_PRG_CACHE
+	sauByteArr dir = {0}, text = {0}, key = {0}, path = {0};
+	if (use_cache && !get_cache_dir(&dir)) use_cache = false;
+#else
+	(void)use_cache;
+#endif
 	for (size_t i = 0; i < script_args->count; ++i) {
-		const sauProgram *prg = sau_build_Program(&script_args->a[i]);
+		const sauScriptArg *arg = &script_args->a[i];
+		const sauProgram *prg = NULL;
+#if USE_PRG_CACHE
+		sauScriptArg text_arg = *arg;
+		bool cache_prg = use_cache &&
+			(!arg->is_path || read_script_text(arg->str, &text)) &&
+			get_cache_key(arg, &text, &key) &&
+			get_cache_path(&dir, &key, &path);
+		if (cache_prg && arg->is_path) {
+			text_arg.str = (char*) text.a;
+			text_arg.is_path = false;
+			text_arg.name = arg->str;
+		}
+		if (cache_prg &&
+		    (prg = sau_load_Program((char*) path.a,
+				    key.a, key.count)) != NULL)
+			utimensat(AT_FDCWD, (char*) path.a, NULL, 0);
+		if (!prg) {
+			prg = sau_build_Program(cache_prg ? &text_arg : arg);
+			if (prg && cache_prg && !prg->time_used &&
+			    sau_save_Program(prg, (char*) path.a,
+					    key.a, key.count))
+				trim_cache_dir(&dir);
+		}
+#else
+		prg = sau_build_Program(arg);
+#endif
 		if (prg != NULL) ++built;
 		sauProgramArr_push(prg_objs, &prg);
 	}
+#if USE_PRG_CACHE
+	sauByteArr_clear(&dir);
+	sauByteArr_clear(&text);
+	sauByteArr_clear(&key);
+	sauByteArr_clear(&path);
+#endif
 	return built;
 }
 
@@ -476,6 +761,7 @@ struct Player {
 	SGS_SndFile *sf;
 	int16_t *buf, *ad_buf;
 	uint32_t srate, ad_srate;
+	uint32_t block_len;
 	uint32_t options;
 	uint32_t ch_count;
 	uint32_t ch_len, ad_ch_len;
@@ -488,6 +774,7 @@ struct Player {
  * \return true unless error occurred
  */
 static bool init_Player(struct Player *restrict o, uint32_t srate,
+		uint32_t block_len,
 		uint32_t options, const char *restrict wav_path) {
 	bool split_gen = false;
 	bool use_audiodev = (wav_path) ?
@@ -496,6 +783,7 @@ static bool init_Player(struct Player *restrict o, uint32_t srate,
 	bool use_stdout = (options & OPT_AUDIO_STDOUT);
 	uint32_t ad_srate = srate;
 	*o = (struct Player){0};
+	o->block_len = block_len;
 	o->options = options;
 	o->ch_count = (options & OPT_AUDIO_MONO) ? 1 : 2;
 	if ((options & OPT_MODE_CHECK) != 0)
@@ -566,6 +854,89 @@ static bool raw_audio_write(FILE *restrict f, uint32_t channels,
 	return samples == fwrite(buf, channels * sizeof(int16_t), samples, f);
 }
 
+/*
+ * Write \p len samples from the main buffer to the outputs using it,
+ * including system audio unless it uses a separate buffer.
+ *
+ * \return true unless error occurred
+ */
+static bool Player_write(struct Player *restrict o, size_t len) {
+	bool use_stdout = (o->options & OPT_AUDIO_STDOUT);
+	bool error = false;
+	if (!o->ad_buf && o->ad && !SGS_AudioDev_write(o->ad, o->buf, len)) {
+		sau_error(NULL, "system audio write failed");
+		error = true;
+	}
+	if (use_stdout && !raw_audio_write(stdout,
+				o->ch_count, o->buf, len)) {
+		sau_error(NULL, "raw audio stdout write failed");
+		error = true;
+	}
+	if (o->sf && !SGS_SndFile_write(o->sf, o->buf, len)) {
+		sau_error(NULL, "%s file write failed",
+				SGS_SndFile_formats[
+				(o->options & OPT_AUFILE_STDOUT) ?
+				SGS_SNDFILE_AU :
+				SGS_SNDFILE_WAV]);
+		error = true;
+	}
+	return !error;
+}
+
+/*
+ * Write \p len samples from the separate buffer for system audio.
+ *
+ * \return true unless error occurred
+ */
+static bool Player_write_ad(struct Player *restrict o, size_t len) {
+	if (o->ad && !SGS_AudioDev_write(o->ad, o->ad_buf, len)) {
+		sau_error(NULL, "system audio write failed");
+		return false;
+	}
+	return true;
+}
+
+static void print_mp_stats(const char *restrict label,
+		const sauMempoolStats *restrict st) {
+	sau_printf("  %-15s%10zu%10zu%8zu%8zu%10zu\n", label,
+			st->requested, st->reserved, st->blocks,
+			st->waste, st->largest);
+}
+
+/*
+ * Print memory use for program \p prg and its generator, by pool.
+ * The generator's buffers are also listed as part of its pool.
+ * For a parsed program, the parser's symbol table use follows.
+ */
+static void print_mem_stats(const sauProgram *restrict prg,
+		const sauGenerator *restrict gen) {
+	sauMempoolStats prg_mem;
+	sauGeneratorMemStats gen_mem;
+	sauGenerator_get_mem_stats(gen, &gen_mem);
+	sau_printf("Memory use (bytes):  requested  reserved"
+			"  blocks   waste   largest\n");
+	if (prg->image != NULL) {
+		sau_printf("  %-15s%10zu%10zu\n", "program image",
+				prg->image_len, prg->image_len);
+	} else if (prg->mp != NULL) {
+		sau_mp_stats(prg->mp, &prg_mem);
+		print_mp_stats("parse pool", &prg->parse_mem);
+		sau_printf("   (script data)%10zu\n", prg->script_mem);
+		print_mp_stats("program pool", &prg_mem);
+	}
+	print_mp_stats("generator pool", &gen_mem.pool);
+	sau_printf("   (gen_bufs)   %10zu\n"
+			"   (mix_bufs)   %10zu\n",
+			gen_mem.gen_bufs, gen_mem.mix_bufs);
+	if (prg->image == NULL && prg->mp != NULL) {
+		const sauSymtabStats *st = &prg->sym_stats;
+		sau_printf("Symbol table: %zu strings, %zu slots, "
+				"%zu lookups, %zu probes (max %zu)\n",
+				st->count, st->alloc,
+				st->lookups, st->probes, st->max_probes);
+	}
+}
+
 /*
  * Produce audio for program \p prg, optionally sending it
  * to the audio device and/or WAV file.
@@ -575,46 +946,41 @@ static bool raw_audio_write(FILE *restrict f, uint32_t channels,
 static bool Player_run(struct Player *restrict o,
 		const sauProgram *restrict prg) {
 	bool use_stereo = !(o->options & OPT_AUDIO_MONO);
-	bool use_stdout = (o->options & OPT_AUDIO_STDOUT);
 	bool split_gen = o->ad_buf;
 	bool run = !(o->options & OPT_MODE_CHECK);
 	bool error = false;
+	uint32_t block_len = o->block_len;
 	sauGenerator *gen = NULL, *ad_gen = NULL;
-	if (!(gen = sau_create_Generator(prg, o->srate)))
+	if (run && (o->options & OPT_TUNE_BLOCK) != 0) {
+		block_len = sau_tune_Generator(prg, o->srate,
+				o->ch_len, use_stereo);
+		if (!block_len)
+			return false;
+		if ((o->options & OPT_PRINT_VERBOSE) != 0)
+			sau_printf("Block length %u (auto-tuned).\n",
+					block_len);
+	}
+	if (!(gen = sau_create_Generator(prg, o->srate, block_len)))
 		return false;
-	if (split_gen && !(ad_gen = sau_create_Generator(prg, o->ad_srate))) {
+	if ((o->options & OPT_PRINT_VERBOSE) != 0)
+		print_mem_stats(prg, gen);
+	if (split_gen && !(ad_gen = sau_create_Generator(prg, o->ad_srate,
+					block_len))) {
 		error = true;
 		goto ERROR;
 	}
 	while (run) {
-		int16_t *buf = o->buf, *ad_buf = NULL;
 		size_t len, ad_len;
-		run = sauGenerator_run(gen, buf, o->ch_len, use_stereo, &len);
+		run = sauGenerator_run(gen, o->buf, o->ch_len,
+				use_stereo, &len);
 		if (split_gen) {
-			ad_buf = o->ad_buf;
-			run |= sauGenerator_run(ad_gen, ad_buf, o->ad_ch_len,
-					use_stereo, &ad_len);
-		} else {
-			ad_buf = o->buf;
-			ad_len = len;
-		}
-		if (o->ad && !SGS_AudioDev_write(o->ad, ad_buf, ad_len)) {
-			sau_error(NULL, "system audio write failed");
-			error = true;
-		}
-		if (use_stdout && !raw_audio_write(stdout,
-					o->ch_count, buf, len)) {
-			sau_error(NULL, "raw audio stdout write failed");
-			error = true;
+			run |= sauGenerator_run(ad_gen, o->ad_buf,
+					o->ad_ch_len, use_stereo, &ad_len);
+			if (!Player_write_ad(o, ad_len))
+				error = true;
 		}
-		if (o->sf && !SGS_SndFile_write(o->sf, buf, len)) {
-			sau_error(NULL, "%s file write failed",
-					SGS_SndFile_formats[
-					(o->options & OPT_AUFILE_STDOUT) ?
-					SGS_SNDFILE_AU :
-					SGS_SNDFILE_WAV]);
+		if (!Player_write(o, len))
 			error = true;
-		}
 	}
 ERROR:
 	sau_destroy_Generator(gen);
@@ -622,6 +988,108 @@ ERROR:
 	return !error;
 }
 
+/*
+ * State for playing a program as it's streamed, part by part.
+ */
+struct PlayerStream {
+	struct Player *out;
+	sauGenerator *gen, *ad_gen;
+	bool run, ad_run;
+	bool error;
+};
+
+/*
+ * Generate and write audio for as far as the program parts streamed
+ * so far allow, or until the end if the last part has been added.
+ */
+static void PlayerStream_run(struct PlayerStream *restrict o) {
+	struct Player *out = o->out;
+	bool use_stereo = !(out->options & OPT_AUDIO_MONO);
+	size_t len;
+	while (o->run && sauGenerator_ahead_len(o->gen) >= out->ch_len) {
+		o->run = sauGenerator_run(o->gen, out->buf, out->ch_len,
+				use_stereo, &len);
+		if (!Player_write(out, len))
+			o->error = true;
+	}
+	if (!o->ad_gen)
+		return;
+	while (o->ad_run &&
+	       sauGenerator_ahead_len(o->ad_gen) >= out->ad_ch_len) {
+		o->ad_run = sauGenerator_run(o->ad_gen, out->ad_buf,
+				out->ad_ch_len, use_stereo, &len);
+		if (!Player_write_ad(out, len))
+			o->error = true;
+	}
+}
+
+/*
+ * Stream function for sau_stream_Program(), playing each part as
+ * far as possible before returning, and the last until completion.
+ *
+ * \return true unless error occurred
+ */
+static bool PlayerStream_part(void *restrict data,
+		const sauProgram *restrict part) {
+	struct PlayerStream *o = data;
+	struct Player *out = o->out;
+	if (!o->gen) {
+		if ((out->options & OPT_PRINT_VERBOSE) != 0)
+			sau_printf("Playing \"%s\" part-wise.\n", part->name);
+		if (!(o->gen = sau_create_Generator(part, out->srate,
+						out->block_len)) ||
+		    (out->ad_buf && !(o->ad_gen = sau_create_Generator(part,
+						out->ad_srate, out->block_len))))
+			return false;
+		o->run = o->ad_run = true;
+	} else if (!sauGenerator_add_part(o->gen, part) ||
+	           (o->ad_gen && !sauGenerator_add_part(o->ad_gen, part))) {
+		return false;
+	}
+	PlayerStream_run(o);
+	if (!(part->mode & SAU_PMODE_STREAM) &&
+	    (out->options & OPT_PRINT_VERBOSE) != 0)
+		print_mem_stats(part, o->gen);
+	return !o->error;
+}
+
+/*
+ * Read and play the listed scripts one at a time, each part-wise,
+ * so that audio for each part is generated before the next is read.
+ *
+ * \return true unless error occurred, or no script could be read
+ */
+static bool stream(const sauScriptArgArr *restrict script_args,
+		uint32_t srate, uint32_t block_len,
+		uint32_t options, const char *restrict wav_path) {
+	struct Player out;
+	bool status = true;
+	size_t read = 0;
+	if (!init_Player(&out, srate, block_len, options, wav_path)) {
+		status = false;
+		goto CLEANUP;
+	}
+	if (out.ad_buf) sau_warning(NULL,
+			"generating audio twice, using different sample rates");
+	for (size_t i = 0; i < script_args->count; ++i) {
+		struct PlayerStream ps = {.out = &out};
+		if (sau_stream_Program(&script_args->a[i],
+					PlayerStream_part, &ps))
+			++read;
+		if (ps.error)
+			status = false;
+		sau_destroy_Generator(ps.gen);
+		sau_destroy_Generator(ps.ad_gen);
+	}
+	if (!read)
+		status = false;
+
+CLEANUP:
+	if (!fini_Player(&out))
+		status = false;
+	return status;
+}
+
 /*
  * Run the listed programs through the audio generator until completion,
  * ignoring NULL entries.
@@ -632,13 +1100,14 @@ ERROR:
  * \return true unless error occurred
  */
 static bool play(const sauProgramArr *restrict prg_objs, uint32_t srate,
+		uint32_t block_len,
 		uint32_t options, const char *restrict wav_path) {
 	if (!prg_objs->count)
 		return true;
 
 	struct Player out;
 	bool status = true;
-	if (!init_Player(&out, srate, options, wav_path)) {
+	if (!init_Player(&out, srate, block_len, options, wav_path)) {
 		status = false;
 		goto CLEANUP;
 	}
@@ -674,16 +1143,31 @@ int main(int argc, char **restrict argv) {
 	const char *wav_path = NULL;
 	uint32_t options = 0;
 	uint32_t srate = 0;
+	uint32_t block_len = 0;
 	if (!parse_args(argc, argv, &options, &script_args, &predef_args,
-				&wav_path, &srate))
+				&wav_path, &srate, &block_len))
 		return 0;
-	bool error = !read_scripts(&script_args, &prg_objs);
+	if (!sau_global_init_Parser()) {
+		sau_error(NULL, "memory allocation failure");
+		sauScriptPredefArr_clear(&predef_args);
+		sauScriptArgArr_clear(&script_args);
+		return 1;
+	}
+	if ((options & OPT_STREAM) != 0) {
+		bool error = !stream(&script_args, srate, block_len,
+				options, wav_path);
+		sauScriptPredefArr_clear(&predef_args);
+		sauScriptArgArr_clear(&script_args);
+		return error ? 1 : 0;
+	}
+	bool error = !read_scripts(&script_args, &prg_objs,
+			options & OPT_USE_CACHE);
 	sauScriptPredefArr_clear(&predef_args);
 	sauScriptArgArr_clear(&script_args);
 	if (error)
 		return 1;
 	if (prg_objs.count > 0) {
-		error = !play(&prg_objs, srate, options, wav_path);
+		error = !play(&prg_objs, srate, block_len, options, wav_path);
 		discard(&prg_objs);
 		if (error)
 			return 1;
@@ -0,0 +1,203 @@
+/* saugns: Test program for the program builder API.
+ * Copyright (c) 2024 Joel K. Pettersson
+ * <joelkp@tuta.io>.
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+#include "saugns.h"
+#include <sau/builder.h>
+#include <sau/math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#define NAME "test-builder"
+
+/*
+ * Script giving the program built by build_program().
+ */
+static const char script[] =
+"'a Wsin f200 t1 p[Wsin r2 a0.5]\n"
+"/0.5 @a f300 a.r[Nre]\n"
+"|\n"
+"/1 @a a0.5 t2 a.r-[Nvi]\n"
+"Rcos f50 s0.25 mgh3 f[Wtri f4]\n"
+"/0.5 Wsqr f100 p0.25 a0.5[g0.2 t0.5, g1 t0.25 lexp]\n"
+"/0.5 Wsaw f.r[g2 t1]\n";
+
+static sauLine state_line(float v0, bool ratio) {
+	return (sauLine){.v0 = v0, .flags = SAU_LINEP_STATE |
+		(ratio ? SAU_LINEP_STATE_RATIO : 0)};
+}
+
+/*
+ * Build the program for the script, using the builder API.
+ *
+ * \return instance or NULL on error
+ */
+static sauProgram *build_program(void) {
+	sauBuilder *o = sau_create_Builder("<string>", NULL);
+	if (!o)
+		return NULL;
+	union sauPOPMode mode = {0};
+	sauLine line;
+	uint32_t a, p, n, r, f, s, w;
+	a = sauBuilder_add_op(o, SAU_POPT_N_wave, SAU_POP_NO_ID,
+			SAU_POP_N_carr);
+	line = state_line(200, false);
+	sauBuilder_set_line(o, a, SAU_PSWEEP_FREQ, &line);
+	sauBuilder_set_time(o, a, 1000);
+	p = sauBuilder_add_op(o, SAU_POPT_N_wave, a, SAU_POP_N_pmod);
+	line = state_line(2, true);
+	sauBuilder_set_line(o, p, SAU_PSWEEP_FREQ, &line);
+	line = state_line(0.5f, false);
+	sauBuilder_set_line(o, p, SAU_PSWEEP_AMP, &line);
+	sauBuilder_release_op(o, p);
+	/* '/' within an operator's step adds an update for it, as below */
+	sauBuilder_wait(o, 500);
+	sauBuilder_update_op(o, a);
+	sauBuilder_update_op(o, a);
+	line = state_line(300, false);
+	sauBuilder_set_line(o, a, SAU_PSWEEP_FREQ, &line);
+	n = sauBuilder_add_op(o, SAU_POPT_N_noise, a, SAU_POP_N_ramod);
+	mode.main = SAU_NOISE_N_re;
+	sauBuilder_set_mode(o, n, mode);
+	sauBuilder_release_op(o, n);
+	sauBuilder_end_group(o);
+	sauBuilder_wait(o, 1000);
+	sauBuilder_update_op(o, a);
+	line = state_line(0.5f, false);
+	sauBuilder_set_line(o, a, SAU_PSWEEP_AMP, &line);
+	sauBuilder_set_time(o, a, 2000);
+	sauBuilder_clear_mods(o, a, SAU_POP_N_ramod);
+	n = sauBuilder_add_op(o, SAU_POPT_N_noise, a, SAU_POP_N_ramod);
+	mode.main = SAU_NOISE_N_vi;
+	sauBuilder_set_mode(o, n, mode);
+	sauBuilder_release_op(o, n);
+	sauBuilder_release_op(o, a);
+	r = sauBuilder_add_op(o, SAU_POPT_N_raseg, SAU_POP_NO_ID,
+			SAU_POP_N_carr);
+	mode = (union sauPOPMode){0};
+	mode.ras.line = SAU_LINE_N_cos;
+	mode.ras.func = SAU_RAS_F_GAUSS;
+	mode.ras.flags = SAU_RAS_O_LINE_SET | SAU_RAS_O_FUNC_SET |
+		SAU_RAS_O_HALFSHAPE | SAU_RAS_O_LEVEL_SET;
+	mode.ras.level = sau_ras_level(3);
+	sauBuilder_set_mode(o, r, mode);
+	line = state_line(50, false);
+	sauBuilder_set_line(o, r, SAU_PSWEEP_FREQ, &line);
+	sauBuilder_set_seed(o, r, sau_cyclepos_dtoui32(0.25));
+	f = sauBuilder_add_op(o, SAU_POPT_N_wave, r, SAU_POP_N_fmod);
+	mode = (union sauPOPMode){0};
+	mode.main = SAU_WAVE_N_tri;
+	sauBuilder_set_mode(o, f, mode);
+	line = state_line(4, false);
+	sauBuilder_set_line(o, f, SAU_PSWEEP_FREQ, &line);
+	sauBuilder_release_op(o, f);
+	sauBuilder_wait(o, 500);
+	sauBuilder_update_op(o, r);
+	sauBuilder_release_op(o, r);
+	s = sauBuilder_add_op(o, SAU_POPT_N_wave, SAU_POP_NO_ID,
+			SAU_POP_N_carr);
+	mode.main = SAU_WAVE_N_sqr;
+	sauBuilder_set_mode(o, s, mode);
+	line = state_line(100, false);
+	sauBuilder_set_line(o, s, SAU_PSWEEP_FREQ, &line);
+	sauBuilder_set_phase(o, s, sau_cyclepos_dtoui32(0.25));
+	sauLineSeg seg = {1.f, 250, SAU_LINE_N_exp, 0};
+	line = (sauLine){.v0 = 0.5f, .vt = 0.2f, .time_ms = 500,
+		.segs = &seg, .seg_count = 1,
+		.flags = SAU_LINEP_STATE | SAU_LINEP_GOAL | SAU_LINEP_TIME};
+	sauBuilder_set_line(o, s, SAU_PSWEEP_AMP, &line);
+	sauBuilder_wait(o, 500);
+	sauBuilder_update_op(o, s);
+	sauBuilder_release_op(o, s);
+	w = sauBuilder_add_op(o, SAU_POPT_N_wave, SAU_POP_NO_ID,
+			SAU_POP_N_carr);
+	mode.main = SAU_WAVE_N_saw;
+	sauBuilder_set_mode(o, w, mode);
+	line = (sauLine){.vt = 2, .time_ms = 1000,
+		.flags = SAU_LINEP_GOAL | SAU_LINEP_TIME};
+	sauBuilder_set_line(o, w, SAU_PSWEEP_FREQ2, &line);
+	sauBuilder_release_op(o, w);
+	return sau_finish_Builder(o);
+}
+
+/*
+ * Get the info printout for \p prg, as for the -p option of saugns,
+ * by sending stdout to a temporary file while it's printed.
+ *
+ * \return allocated string, or NULL on error
+ */
+static char *get_print_info(const sauProgram *restrict prg) {
+	FILE *f = tmpfile();
+	char *str = NULL;
+	long len;
+	int out_fd;
+	if (!f)
+		return NULL;
+	fflush(stdout);
+	if ((out_fd = dup(STDOUT_FILENO)) < 0)
+		goto DONE;
+	if (dup2(fileno(f), STDOUT_FILENO) >= 0) {
+		sauProgram_print_info(prg);
+		fflush(stdout);
+		dup2(out_fd, STDOUT_FILENO);
+	}
+	close(out_fd);
+	if (fseek(f, 0, SEEK_END) != 0 || (len = ftell(f)) < 0 ||
+	    fseek(f, 0, SEEK_SET) != 0 || !(str = malloc(len + 1)))
+		goto DONE;
+	str[fread(str, 1, len, f)] = '\0';
+DONE:
+	fclose(f);
+	return str;
+}
+
+/*
+ * Build the test program both with the builder and from the script,
+ * and compare their info printouts, printing both if they differ.
+ */
+int main(void) {
+	sauScriptArg arg = {.str = script, .no_time = true};
+	if (!sau_global_init_Parser())
+		return 1;
+	sauProgram *b_prg = build_program();
+	sauProgram *s_prg = sau_build_Program(&arg);
+	char *b_info = NULL, *s_info = NULL;
+	bool error = true;
+	if (!b_prg || !s_prg) {
+		fputs(NAME": failed to build program\n", stderr);
+		goto DONE;
+	}
+	if (!(b_info = get_print_info(b_prg)) ||
+	    !(s_info = get_print_info(s_prg))) {
+		fputs(NAME": failed to get program printout\n", stderr);
+		goto DONE;
+	}
+	if (strcmp(b_info, s_info) != 0) {
+		fprintf(stderr,
+NAME": builder and script programs differ\n"
+"Builder:\n%s\nScript:\n%s", b_info, s_info);
+		goto DONE;
+	}
+	error = false;
+DONE:
+	free(b_info);
+	free(s_info);
+	sau_discard_Program(b_prg);
+	sau_discard_Program(s_prg);
+	return error;
+}
@@ -91,7 +91,7 @@ static bool parse_args(int argc, char **restrict argv,
 		arg = *argv;
 		if (*arg != '-') {
 			struct sauScriptArg entry = {arg};
-			sauScriptArgArr_add(script_args, &entry);
+			sauScriptArgArr_push(script_args, &entry);
 			continue;
 		}
 NEXT_C:
@@ -198,13 +198,13 @@ static sauProgram *build_program(const char *restrict script_arg,
 		bool is_path) {
 	sauProgram *o = NULL;
 	sauMempool *mempool = sau_create_Mempool(0);
-	sauSymtab *symtab = sau_create_Symtab(mempool);
+	sauSymtab *symtab = sau_create_Symtab(mempool, NULL);
 	if (!symtab)
 		return NULL;
 #if TEST_SCANNER
 	sauScanner *scanner = sau_create_Scanner(symtab);
 	if (!scanner) goto CLOSE;
-	if (!sauScanner_open(scanner, script_arg, is_path)) goto CLOSE;
+	if (!sauScanner_open(scanner, script_arg, is_path, NULL)) goto CLOSE;
 	/* print file contents with whitespace and comment filtering */
 	//scan_simple(scanner);
 	scan_with_undo(scanner);
@@ -238,10 +238,15 @@ static size_t read_scripts(const sauScriptArgArr *restrict script_args,
 	bool are_paths = !(options & OPT_EVAL_STRING);
 	size_t built = 0;
 	for (size_t i = 0; i < script_args->count; ++i) {
-		const sauProgram *prg = build_program(script_args->a[i].str,
+		sauProgram *prg = build_program(script_args->a[i].str,
 				are_paths);
+		sauProgram **item = sauProgramArr_add(prg_objs);
+		if (!item) {
+			free(prg);
+			break;
+		}
+		*item = prg;
 		if (prg != NULL) ++built;
-		sauProgramArr_add(prg_objs, &prg);
 	}
 	return built;
 }